@@ -0,0 +1,1166 @@
+#include "aerodrome_engine.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+
+namespace detail {
+
+// sentinels returned by the taxiway queue checks
+inline size_t FAIL_POINT = static_cast<size_t>(-2);
+inline size_t SKIP_POINT = static_cast<size_t>(-1);
+
+// Checkpoints are a sequence of little-endian 32 bit words, starting with the
+// magic and the version. Bump the version on every layout change.
+constexpr std::uint32_t STATE_MAGIC = 0x4d445241;  // "ARDM"
+constexpr std::uint32_t STATE_VERSION = 1;
+// the standard library, whose hash and bucket policy decide the order waiting
+// arrivals are admitted in
+#if defined(_LIBCPP_VERSION)
+constexpr std::uint32_t STATE_LIBRARY = 2;
+#elif defined(__GLIBCXX__)
+constexpr std::uint32_t STATE_LIBRARY = 1;
+#elif defined(_MSC_VER)
+constexpr std::uint32_t STATE_LIBRARY = 3;
+#else
+constexpr std::uint32_t STATE_LIBRARY = 0;
+#endif
+// generator words and waiting buckets are far fewer, the bounds only guard
+// against corrupted files
+constexpr size_t MAX_GENERATOR_WORDS = 1024;
+constexpr size_t MAX_WAITING_BUCKETS = 1024;
+
+inline void put_word(std::ostream& out, size_t value) {
+    char bytes[4];
+    for (int i = 0; i != 4; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    out.write(bytes, 4);
+}
+
+// fails on a word not less than `bound`
+inline bool get_word(std::istream& in, size_t& value, std::uint64_t bound) {
+    unsigned char bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), 4)) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i != 4; ++i) {
+        value |= static_cast<size_t>(bytes[i]) << (8 * i);
+    }
+    return static_cast<std::uint64_t>(value) < bound;
+}
+
+// `to` is a step after `from` on the departure trajectories
+inline bool follows(size_t from, size_t to) {
+    auto single = aerodrome_engine::DEPARTURES_TRAJECTORY.find(from);
+    if (single != aerodrome_engine::DEPARTURES_TRAJECTORY.end()) {
+        return single->second == to;
+    }
+    auto variadic = aerodrome_engine::DEPARTURES_VARIADIC_TRAJECTORY.find(from);
+    return variadic != aerodrome_engine::DEPARTURES_VARIADIC_TRAJECTORY.end()
+            && std::find(variadic->second.begin(), variadic->second.end(), to) != variadic->second.end();
+}
+
+// Every taxiway endpoint but an entry is passed only at the front of its queue,
+// so its taxiway has to be `held` or entered before. Walks every trajectory a
+// departure at `point_id` may take, they have no cycles.
+inline bool departure_holds(size_t point_id, std::uint32_t held) {
+    auto endpoint = aerodrome_engine::TAXIWAY_ENDPOINTS.find(point_id);
+    if (endpoint != aerodrome_engine::TAXIWAY_ENDPOINTS.end()) {
+        auto [way, type] = endpoint->second;
+        if (type == taxiway_endpoints_t::START) {
+            held |= 1u << way;
+        } else if (!(held >> way & 1)) {
+            return false;
+        }
+    }
+
+    auto single = aerodrome_engine::DEPARTURES_TRAJECTORY.find(point_id);
+    if (single != aerodrome_engine::DEPARTURES_TRAJECTORY.end()) {
+        return departure_holds(single->second, held);
+    }
+    auto variadic = aerodrome_engine::DEPARTURES_VARIADIC_TRAJECTORY.find(point_id);
+    if (variadic != aerodrome_engine::DEPARTURES_VARIADIC_TRAJECTORY.end()) {
+        return std::all_of(variadic->second.begin(), variadic->second.end(), [held](size_t step) {
+            return departure_holds(step, held);
+        });
+    }
+    return true;
+}
+
+// Every word of a state may be in range and the state still be one the schedule
+// can not tick, e.g. an aircraft at the end of a taxiway it holds no place on,
+// whose queue is then taken the front of while empty. Checks what the tick
+// relies on: unique aircraft, waiting ones among the arrivals, queues of live
+// aircraft only, arrival routes leading to their gates and a place in the queue
+// of every taxiway an aircraft is going to leave.
+inline bool consistent_state(const vector<pair<size_t, size_t>>& departures,
+                             const vector<pair<size_t, vector<size_t>>>& arrivals,
+                             const vector<pair<size_t, vector<size_t>>>& waiting,
+                             const vector<vector<size_t>>& queues) {
+    enum owner_t : char { FREE, DEPARTURE, ARRIVAL };
+    vector<char> owner(aerodrome_engine::SPAWNPOINT.size(), FREE);
+    vector<char> waits(aerodrome_engine::SPAWNPOINT.size(), 0);
+
+    for (auto& [id, point_id] : departures) {
+        if (owner[id] != FREE) {
+            return false;
+        }
+        owner[id] = DEPARTURE;
+    }
+    for (auto& [id, steps] : arrivals) {
+        if (owner[id] != FREE) {
+            return false;
+        }
+        owner[id] = ARRIVAL;
+    }
+    for (auto& [id, taxiways_needed] : waiting) {
+        if (owner[id] != ARRIVAL || waits[id]) {
+            return false;
+        }
+        waits[id] = 1;
+    }
+    for (const vector<size_t>& que : queues) {
+        for (size_t id : que) {
+            if (owner[id] == FREE) {
+                return false;
+            }
+        }
+    }
+
+    // taxiways of every aircraft as a mask, waiting arrivals take theirs when they land
+    vector<std::uint32_t> held(aerodrome_engine::SPAWNPOINT.size(), 0);
+    for (size_t way = 0; way != queues.size(); ++way) {
+        for (size_t id : queues[way]) {
+            held[id] |= 1u << way;
+        }
+    }
+    for (auto& [id, taxiways_needed] : waiting) {
+        for (size_t way : taxiways_needed) {
+            held[id] |= 1u << way;
+        }
+    }
+
+    for (auto& [id, point_id] : departures) {
+        if (!departure_holds(point_id, held[id])) {
+            return false;
+        }
+    }
+    for (auto& [id, steps] : arrivals) {
+        // routes are walked from the runway, so they are the departure trajectories backwards
+        if (steps.back() != aerodrome_engine::SPAWNPOINT[id]) {
+            return false;
+        }
+        for (size_t i = 0; i + 1 < steps.size(); ++i) {
+            if (!follows(steps[i + 1], steps[i])) {
+                return false;
+            }
+        }
+        // arrivals enter no taxiway on the way, they are queued on all of them when they land
+        for (size_t point_id : steps) {
+            auto endpoint = aerodrome_engine::TAXIWAY_ENDPOINTS.find(point_id);
+            if (endpoint != aerodrome_engine::TAXIWAY_ENDPOINTS.end() && !(held[id] >> endpoint->second.first & 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+
+using detail::taxiway_endpoints_t;
+
+aerodrome_engine::aerodrome_engine(unsigned seed)
+    : frame_arena(frame_buffer.data(), frame_buffer.size(), &pool),
+      generator(seed),
+      departure_aircrafts(&pool),
+      arrival_aircrafts(&pool),
+      arival_waiting_aircrafts(&pool),
+      taxiway_que(TAXIWAY_COUNT, &pool)
+{
+    departure_aircrafts.reserve(SPAWNPOINT.size());
+    arrival_aircrafts.reserve(SPAWNPOINT.size());
+    reserve_pool();
+}
+
+
+// The pool grows only when a state is larger than any before it, which at the
+// maximum plane number may take a long time to happen. A state larger than the
+// schedule can make is built once and released, so its blocks stay in the pool:
+// every aircraft arriving along the whole graph, every queue holding every
+// aircraft and waiting lists of every length. All are held at once, as ticks do.
+void aerodrome_engine::reserve_pool() {
+    const size_t aircraft = SPAWNPOINT.size();
+
+    std::pmr::vector<route_t> routes(&pool);
+    std::pmr::vector<taxiway_queue_t> queues(&pool);
+    std::pmr::vector<std::pmr::vector<size_t>> lists(&pool);
+    waiting_t waiting(&pool);
+    routes.reserve(aircraft);
+    queues.reserve(TAXIWAY_COUNT);
+    lists.reserve(aircraft * TAXIWAY_COUNT);
+
+    for (size_t id = 0; id != aircraft; ++id) {
+        routes.emplace_back(POINT_BY_ID.size(), FAKE_POINT);
+        waiting[id].assign(TAXIWAY_COUNT, 0);
+        for (size_t length = 1; length <= TAXIWAY_COUNT; ++length) {
+            lists.emplace_back(length, 0);
+        }
+    }
+    for (size_t way = 0; way != TAXIWAY_COUNT; ++way) {
+        queues.emplace_back(2 * aircraft, 0);
+    }
+}
+
+
+// Both aircraft vectors are compacted in place: every aircraft is written at most
+// once, to a position not after its own, so no next-state copies are needed.
+void aerodrome_engine::update_aerodrome() {
+
+    assert(plane_number_ <= SPAWNPOINT.size());
+
+    frame_arena.release();
+    departed_flights = 0;
+    std::pmr::vector<char> non_free_ids(SPAWNPOINT.size(), 0, &frame_arena);
+    std::pmr::vector<char> non_free_points(POINT_BY_ID.size(), 0, &frame_arena);
+    size_t next_departures = 0;
+    size_t next_arrivals = 0;
+
+    auto fix_non_free = [&](size_t id, size_t step) -> void {
+        non_free_ids[id] = 1;
+        non_free_points[step] = 1;
+    };
+
+    auto make_step_departure = [&](size_t id, size_t step) -> void {
+        departure_aircrafts[next_departures++] = {id, step};
+        fix_non_free(id, step);
+    };
+
+    auto keep_arrival = [&](size_t i) -> void {
+        if (next_arrivals != i) {
+            arrival_aircrafts[next_arrivals] = std::move(arrival_aircrafts[i]);
+        }
+        ++next_arrivals;
+    };
+
+    auto make_step_arrival = [&](size_t i, size_t id, route_t& steps) -> void {
+        if (steps.empty()) {
+            return;
+        }
+        fix_non_free(id, steps.front());
+        keep_arrival(i);
+    };
+
+    auto in_ith_queue = [&](size_t que_id, size_t plane_id) -> bool {
+        return std::find(taxiway_que[que_id].begin(), taxiway_que[que_id].end(), plane_id) != taxiway_que[que_id].end();
+    };
+
+    auto compute_queues = [&](size_t id, size_t current_point, size_t step_point,
+            taxiway_endpoints_t START = taxiway_endpoints_t::START,
+            taxiway_endpoints_t END = taxiway_endpoints_t::END,
+            bool last_one = false) -> size_t {
+
+        if (TAXIWAY_ENDPOINTS.count(current_point)) {
+            size_t result = detail::SKIP_POINT;
+            auto [way_id, point_type] = TAXIWAY_ENDPOINTS[current_point];
+
+            if (point_type == START && !in_ith_queue(way_id, id)) {
+                taxiway_que[way_id].push_back(id);
+            }
+
+            if (taxiway_que[way_id].front() == id) {
+                if (!last_one) {
+                    result = step_point;
+                }
+                if (point_type == END) {
+                    taxiway_que[way_id].pop_front();
+                }
+            } else {
+                result = current_point;
+            }
+            return result;
+        }
+        return detail::FAIL_POINT;
+    };
+
+
+
+    helper_position += helper_position_delta;
+    if (helper_position == 0 || helper_position == HELPER_TRAJECTORY.size()) {
+        helper_position_delta = 0;
+    }
+
+    // helper starts moving with 0.04 frequency
+    if (helper_position_delta == 0 && random_below(25) == 0) {
+        helper_position_delta = (helper_position == 0 ? 1 : -1);
+    }
+
+
+    for (size_t i = 0; i != departure_aircrafts.size(); ++i) {
+        size_t id = departure_aircrafts[i].first;
+        size_t current_point = departure_aircrafts[i].second;
+
+        if (DEPARTURES_TRAJECTORY.count(current_point) || DEPARTURES_VARIADIC_TRAJECTORY.count(current_point)) {
+            size_t step_point = DEPARTURES_TRAJECTORY.count(current_point)
+                    ? DEPARTURES_TRAJECTORY[current_point]
+                    : DEPARTURES_VARIADIC_TRAJECTORY[current_point][random_below(DEPARTURES_VARIADIC_TRAJECTORY[current_point].size())];
+
+            if (non_free_points[step_point]) {
+                make_step_departure(id, current_point);
+            } else {
+                size_t result = compute_queues(id, current_point, step_point);
+                if (result == detail::FAIL_POINT) {
+                    make_step_departure(id, step_point);
+                } else {
+                    if (result != detail::SKIP_POINT) {
+                        make_step_departure(id, result);
+                    }
+                }
+            }
+        } else {
+            size_t result = compute_queues(id, current_point, current_point, taxiway_endpoints_t::START, taxiway_endpoints_t::END, true);
+            if (result != detail::FAIL_POINT && result != detail::SKIP_POINT) {
+                make_step_departure(id, result);
+            } else {
+                ++departed_flights;
+            }
+        }
+    }
+
+    departure_aircrafts.resize(next_departures);
+
+
+    for (size_t i = 0; i != arrival_aircrafts.size(); ++i) {
+        size_t id = arrival_aircrafts[i].first;
+        route_t& all_steps = arrival_aircrafts[i].second;
+
+        if (arival_waiting_aircrafts.count(id)) {
+            keep_arrival(i);
+            continue;
+        }
+
+        size_t current_point = all_steps.front();
+        all_steps.pop_front();
+
+        if (!all_steps.empty()) {
+            size_t step_point = all_steps.front();
+
+            if (non_free_points[step_point]) {
+                all_steps.push_front(current_point);
+                make_step_arrival(i, id, all_steps);
+
+            } else {
+                size_t result = compute_queues(id, current_point, step_point, taxiway_endpoints_t::IGNORE, taxiway_endpoints_t::START);
+                if (result == detail::FAIL_POINT) {
+                    make_step_arrival(i, id, all_steps);
+                } else {
+                    if (result != detail::SKIP_POINT) {
+                        if (result == current_point) {
+                            all_steps.push_front(current_point);
+                        }
+                        make_step_arrival(i, id, all_steps);
+                    }
+                }
+            }
+        } else {
+            compute_queues(id, current_point, current_point, taxiway_endpoints_t::IGNORE, taxiway_endpoints_t::START, true);
+            parked_aircraft += networked ? 1 : 0;
+        }
+    }
+
+    arrival_aircrafts.erase(arrival_aircrafts.begin() + static_cast<std::ptrdiff_t>(next_arrivals), arrival_aircrafts.end());
+
+
+    if (arival_waiting_aircrafts.empty()) {
+        for (size_t i = departure_aircrafts.size() + arrival_aircrafts.size(); i < plane_number_; ++i) {
+            size_t id;
+            for (;;) {
+                id = random_below(SPAWNPOINT.size());
+                if (!non_free_ids[id]) {
+                    break;
+                }
+            }
+
+            non_free_ids[id] = 1;
+            // flight is departure with 0.66 frequency
+            bool departure = random_below(3) != 0;
+            if (networked) {
+                departure = inbound_flights == 0;
+                size_t& available = departure ? parked_aircraft : inbound_flights;
+                if (available == 0) {
+                    continue;
+                }
+                --available;
+            }
+            if (departure) {
+                departure_aircrafts.emplace_back(id, SPAWNPOINT[id]);
+                continue;
+            }
+
+            // the route is built backwards, from the gate to the runway
+            arrival_aircrafts.emplace_back(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple());
+            route_t& path = arrival_aircrafts.back().second;
+            size_t temp = SPAWNPOINT[id];
+            std::pmr::vector<size_t> chosen(&frame_arena);
+            while (temp != FAKE_POINT) {
+                path.push_front(temp);
+                if (DEPARTURES_TRAJECTORY.count(temp)) {
+                    temp = DEPARTURES_TRAJECTORY[temp];
+                } else {
+                    chosen.push_back(random_below(DEPARTURES_VARIADIC_TRAJECTORY[temp].size()));
+                    temp = DEPARTURES_VARIADIC_TRAJECTORY[temp][chosen.back()];
+                }
+            }
+            path.push_front(FAKE_POINT);
+
+            if (id < 15) {
+                arival_waiting_aircrafts[id] = {0, 9};
+            } else if (id < 21) {
+                arival_waiting_aircrafts[id] = {8, 1, 0};
+            } else if (id < 29) {
+                arival_waiting_aircrafts[id] = {7, 10, 1, 0};
+            } else if (id < 40) {
+                if (!chosen.empty() && chosen[0] == 0) {
+                    arival_waiting_aircrafts[id] = {6, 10, 4, 0};
+                } else {
+                    arival_waiting_aircrafts[id] = {6, 10, 1, 0};
+                }
+            }
+        }
+    }
+
+    std::pmr::vector<size_t> can_arrive(&frame_arena);
+    for (auto& [id, taxiways_needed] : arival_waiting_aircrafts) {
+        bool ok = true;
+        for (size_t i : taxiways_needed) {
+            ok &= taxiway_que[i].empty();
+        }
+        if (ok) {
+            can_arrive.push_back(id);
+            for (size_t i : taxiways_needed) {
+                taxiway_que[i].push_back(id);
+            }
+            break;
+        }
+    }
+
+    for (size_t i : can_arrive) {
+        arival_waiting_aircrafts.erase(i);
+    }
+}
+
+
+void aerodrome_engine::set_plane_number(size_t value) {
+    plane_number_ = value;
+}
+
+size_t aerodrome_engine::plane_number() const {
+    return plane_number_;
+}
+
+
+const std::pmr::vector<aerodrome_engine::departure_t>& aerodrome_engine::departures() const {
+    return departure_aircrafts;
+}
+
+const std::pmr::vector<aerodrome_engine::arrival_t>& aerodrome_engine::arrivals() const {
+    return arrival_aircrafts;
+}
+
+const aerodrome_engine::waiting_t& aerodrome_engine::waiting_arrivals() const {
+    return arival_waiting_aircrafts;
+}
+
+const std::pmr::vector<aerodrome_engine::taxiway_queue_t>& aerodrome_engine::taxiway_queues() const {
+    return taxiway_que;
+}
+
+size_t aerodrome_engine::helper_point() const {
+    if (helper_position == 0 || helper_position == HELPER_TRAJECTORY.size()) {
+        return FAKE_POINT;
+    }
+    return HELPER_TRAJECTORY[helper_position];
+}
+
+size_t aerodrome_engine::helper_index() const {
+    return helper_position;
+}
+
+int aerodrome_engine::helper_delta() const {
+    return helper_position_delta;
+}
+
+
+// The waiting arrivals are tried in the iteration order of their map, so it is
+// restored too: entries are saved in that order with the bucket count and put
+// back in reverse, each becoming the first one of its bucket. The order and the
+// later growth of the map are details of the standard library, so a state is
+// tagged with it and loaded by the same one only; the restored order is
+// checked as well.
+bool aerodrome_engine::save_state(std::ostream& out) const {
+    using detail::put_word;
+
+    put_word(out, detail::STATE_MAGIC);
+    put_word(out, detail::STATE_VERSION);
+    put_word(out, detail::STATE_LIBRARY);
+    put_word(out, plane_number_);
+    put_word(out, helper_position);
+    put_word(out, static_cast<size_t>(helper_position_delta + 1));
+
+    put_word(out, departure_aircrafts.size());
+    for (auto& [id, point_id] : departure_aircrafts) {
+        put_word(out, id);
+        put_word(out, point_id);
+    }
+
+    put_word(out, arrival_aircrafts.size());
+    for (auto& [id, steps] : arrival_aircrafts) {
+        put_word(out, id);
+        put_word(out, steps.size());
+        for (size_t point_id : steps) {
+            put_word(out, point_id);
+        }
+    }
+
+    put_word(out, arival_waiting_aircrafts.bucket_count());
+    put_word(out, arival_waiting_aircrafts.size());
+    for (auto& [id, taxiways_needed] : arival_waiting_aircrafts) {
+        put_word(out, id);
+        put_word(out, taxiways_needed.size());
+        for (size_t way : taxiways_needed) {
+            put_word(out, way);
+        }
+    }
+
+    for (const taxiway_queue_t& que : taxiway_que) {
+        put_word(out, que.size());
+        for (size_t id : que) {
+            put_word(out, id);
+        }
+    }
+
+    // the textual form is the only portable access to the generator state
+    std::ostringstream text;
+    text << generator;
+    std::istringstream words(text.str());
+    vector<size_t> state{std::istream_iterator<size_t>(words), std::istream_iterator<size_t>()};
+    put_word(out, state.size());
+    for (size_t word : state) {
+        put_word(out, word);
+    }
+
+    return static_cast<bool>(out);
+}
+
+
+bool aerodrome_engine::load_state(std::istream& in) {
+    using detail::get_word;
+
+    const size_t ids = SPAWNPOINT.size();
+    const size_t points = POINT_BY_ID.size();
+    const std::uint64_t any = static_cast<std::uint64_t>(1) << 32;
+
+    size_t magic, version, library, plane_number, position, delta;
+    if (!get_word(in, magic, any) || magic != detail::STATE_MAGIC
+            || !get_word(in, version, any) || version != detail::STATE_VERSION
+            || !get_word(in, library, any) || library != detail::STATE_LIBRARY
+            || !get_word(in, plane_number, ids + 1)
+            || !get_word(in, position, HELPER_TRAJECTORY.size() + 1)
+            || !get_word(in, delta, 3)) {
+        return false;
+    }
+
+    size_t count;
+    vector<departure_t> departures;
+    if (!get_word(in, count, ids + 1)) {
+        return false;
+    }
+    departures.resize(count);
+    for (auto& [id, point_id] : departures) {
+        if (!get_word(in, id, ids) || !get_word(in, point_id, points)) {
+            return false;
+        }
+    }
+
+    vector<pair<size_t, vector<size_t>>> arrivals;
+    if (!get_word(in, count, ids + 1)) {
+        return false;
+    }
+    arrivals.resize(count);
+    for (auto& [id, steps] : arrivals) {
+        if (!get_word(in, id, ids) || !get_word(in, count, points + 1) || count == 0) {
+            return false;
+        }
+        steps.resize(count);
+        for (size_t& point_id : steps) {
+            if (!get_word(in, point_id, points)) {
+                return false;
+            }
+        }
+    }
+
+    size_t buckets;
+    vector<pair<size_t, vector<size_t>>> waiting;
+    if (!get_word(in, buckets, detail::MAX_WAITING_BUCKETS + 1) || !get_word(in, count, ids + 1)) {
+        return false;
+    }
+    waiting.resize(count);
+    for (auto& [id, taxiways_needed] : waiting) {
+        if (!get_word(in, id, ids) || !get_word(in, count, TAXIWAY_COUNT + 1)) {
+            return false;
+        }
+        taxiways_needed.resize(count);
+        for (size_t& way : taxiways_needed) {
+            if (!get_word(in, way, TAXIWAY_COUNT)) {
+                return false;
+            }
+        }
+    }
+
+    vector<vector<size_t>> queues(TAXIWAY_COUNT);
+    for (vector<size_t>& que : queues) {
+        if (!get_word(in, count, 2 * ids + 1)) {
+            return false;
+        }
+        que.resize(count);
+        for (size_t& id : que) {
+            if (!get_word(in, id, ids)) {
+                return false;
+            }
+        }
+    }
+
+    std::ostringstream text;
+    if (!get_word(in, count, detail::MAX_GENERATOR_WORDS + 1)) {
+        return false;
+    }
+    for (size_t i = 0; i != count; ++i) {
+        size_t word;
+        if (!get_word(in, word, any)) {
+            return false;
+        }
+        text << word << ' ';
+    }
+    std::mt19937 restored;
+    std::istringstream words(text.str());
+    if (!(words >> restored) || !detail::consistent_state(departures, arrivals, waiting, queues)) {
+        return false;
+    }
+
+    // a fresh map, as a used one keeps its growth history
+    waiting_t restored_waiting(&pool);
+    if (buckets > 1) {
+        restored_waiting.rehash(buckets);
+    }
+    for (auto entry = waiting.rbegin(); entry != waiting.rend(); ++entry) {
+        restored_waiting[entry->first].assign(entry->second.begin(), entry->second.end());
+    }
+    auto entry = waiting.begin();
+    for (auto& [id, taxiways_needed] : restored_waiting) {
+        if (id != (entry++)->first) {
+            return false;
+        }
+    }
+
+    plane_number_ = plane_number;
+    helper_position = position;
+    helper_position_delta = static_cast<int>(delta) - 1;
+    generator = restored;
+
+    departure_aircrafts.assign(departures.begin(), departures.end());
+
+    arrival_aircrafts.clear();
+    for (auto& [id, steps] : arrivals) {
+        arrival_aircrafts.emplace_back(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple());
+        arrival_aircrafts.back().second.assign(steps.begin(), steps.end());
+    }
+
+    arival_waiting_aircrafts.swap(restored_waiting);
+
+    for (size_t way = 0; way != TAXIWAY_COUNT; ++way) {
+        taxiway_que[way].assign(queues[way].begin(), queues[way].end());
+    }
+    return true;
+}
+
+
+void aerodrome_engine::set_networked(bool enabled) {
+    networked = enabled;
+}
+
+void aerodrome_engine::add_inbound(size_t flights) {
+    inbound_flights += flights;
+}
+
+void aerodrome_engine::add_parked(size_t aircraft) {
+    parked_aircraft += aircraft;
+}
+
+size_t aerodrome_engine::inbound() const {
+    return inbound_flights;
+}
+
+size_t aerodrome_engine::parked() const {
+    return parked_aircraft;
+}
+
+size_t aerodrome_engine::departed() const {
+    return departed_flights;
+}
+
+
+const std::mt19937& aerodrome_engine::random_generator() const {
+    return generator;
+}
+
+
+size_t aerodrome_engine::random_below(size_t bound) {
+    return generator() % bound;
+}
+
+
+vector<point_t> aerodrome_engine::POINT_BY_ID = {
+   {1750, 444},
+   {1750, 420},
+   {1748, 364},
+   {1727, 365},
+   {1748, 324},
+   {1727, 324},
+   {1746, 292},
+   {1746, 269},
+   {1746, 245},
+   {1687, 316},
+   {1687, 336},
+   {1687, 357},
+   {1688, 378},
+   {1689, 398},
+   {1688, 419},
+   {1651, 782},
+   {1629, 782},
+   {1607, 782},
+   {1585, 782},
+   {1564, 782},
+   {1540, 783},
+   {1488, 775},
+   {1462, 775},
+   {1390, 794},
+   {1367, 749},
+   {1334, 749},
+   {1304, 750},
+   {1274, 751},
+   {1246, 751},
+   {1215, 749},
+   {1183, 750},
+   {1150, 749},
+   {1120, 749},
+   {1092, 750},
+   {1093, 785},
+   {1121, 785},
+   {1151, 784},
+   {1182, 785},
+   {1219, 797},
+   {1220, 825},
+   {1731, 447},
+   {1730, 423},
+   {1712, 432},
+   {1713, 454},
+   {1710, 482},
+   {1711, 514},
+   {1711, 548},
+   {1710, 408},
+   {1710, 385},
+   {1732, 385},
+   {1708, 364},
+   {1707, 342},
+   {1732, 344},
+   {1707, 320},
+   {1723, 300},
+   {1725, 278},
+   {1725, 256},
+   {1710, 558},
+   {1560, 760},
+   {1589, 761},
+   {1621, 760},
+   {1651, 759},
+   {1664, 742},
+   {1704, 737},
+   {1711, 702},
+   {1710, 694},
+   {1712, 660},
+   {1712, 633},
+   {1711, 608},
+   {1711, 601},
+   {1706, 578},
+   {1261, 771},
+   {1288, 772},
+   {1317, 770},
+   {1352, 769},
+   {1390, 771},
+   {1415, 778},
+   {1441, 767},
+   {1471, 753},
+   {1442, 736},
+   {1439, 705},
+   {1442, 698},
+   {1468, 683},
+   {1515, 684},
+   {1555, 683},
+   {1595, 683},
+   {1640, 683},
+   {1680, 684},
+   {1690, 682},
+   {1201, 810},
+   {1202, 771},
+   {1166, 766},
+   {1134, 766},
+   {1105, 765},
+   {1076, 767},
+   {1071, 735},
+   {1072, 710},
+   {1075, 702},
+   {1071, 684},
+   {1106, 682},
+   {1143, 683},
+   {1183, 683},
+   {1215, 684},
+   {1249, 683},
+   {1288, 683},
+   {1327, 683},
+   {1366, 683},
+   {1403, 683},
+   {1437, 682},
+   {1045, 683},
+   {1016, 683},
+   {987, 685},
+   {953, 684},
+   {918, 685},
+   {877, 685},
+   {838, 687},
+   {798, 686},
+   {758, 686},
+   {723, 684},
+   {714, 679},
+   {684, 667},
+   {671, 640},
+   {658, 610},
+   {667, 599},
+   {691, 581},
+   {719, 580},
+   {752, 580},
+   {786, 579},
+   {819, 580},
+   {851, 581},
+   {898, 580},
+   {945, 580},
+   {992, 579},
+   {1037, 580},
+   {1086, 580},
+   {1154, 579},
+   {1222, 580},
+   {1293, 579},
+   {1362, 579},
+   {1431, 580},
+   {1677, 579},
+   {1650, 580},
+   {1617, 580},
+   {1583, 580},
+   {1551, 580},
+   {1518, 580},
+   {1471, 580},
+   {1424, 580},
+   {1378, 580},
+   {1331, 580},
+   {1284, 580},
+   {1214, 580},
+   {1144, 580},
+   {1074, 580},
+   {1005, 580},
+   {936, 580},
+   {1354, 593},
+   {1360, 599},
+   {1451, 680},
+   {1461, 683},
+   {1756, 454},
+   {1730, 455},
+   {1719, 477},
+   {1720, 505},
+   {1720, 532},
+   {1720, 560},
+   {1720, 587},
+   {1721, 614},
+   {1721, 643},
+   {1722, 671},
+   {1723, 699},
+   {1721, 728},
+   {1703, 748},
+   {1679, 755},
+   {1658, 765},
+
+    /* detail fake points */
+    {aerodrome_engine::maximum_w * 2 + 1, aerodrome_engine::maximum_h},
+    {aerodrome_engine::maximum_w * 2 + 2, aerodrome_engine::maximum_h},
+    {aerodrome_engine::maximum_w * 2 + 3, aerodrome_engine::maximum_h}
+};
+
+// the fake points close POINT_BY_ID, which has to be initialized first
+const size_t aerodrome_engine::FAKE_POINT = aerodrome_engine::POINT_BY_ID.size() - 3;
+
+
+vector<size_t> aerodrome_engine::HELPER_TRAJECTORY = {
+    FAKE_POINT, 160, 161, 162, 163, 164,
+    165, 166, 167, 168, 169, 170,
+    171, 172, 173, 174, FAKE_POINT
+};
+
+
+vector<size_t> aerodrome_engine::SPAWNPOINT = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+    20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
+    30, 31, 32, 33, 34, 35, 36, 37, 38, 39
+};
+
+
+unordered_map<size_t, size_t> aerodrome_engine::DEPARTURES_TRAJECTORY = {
+    { 0, 40 },
+    { 1, 41 },
+    { 42, 43 },
+    { 41, 42 },
+    { 40, 43 },
+    { 43, 44 },
+    { 44, 45 },
+    { 45, 46 },
+    { 47, 42 },
+    { 48, 47 },
+    { 49, 48 },
+    { 50, 48 },
+    { 51, 50 },
+    { 52, 51 },
+    { 53, 51 },
+    { 54, 53 },
+    { 55, 54 },
+    { 56, 55 },
+    { 8, 56 },
+    { 7, 55 },
+    { 6, 54 },
+    { 9, 53 },
+    { 10, 51 },
+    { 4, 52 },
+    { 11, 50 },
+    { 12, 48 },
+    { 2, 49 },
+    { 13, 47 },
+    { 14, 47 },
+    { 5, 51 },
+    { 3, 48 },
+    { 46, 57 },
+    { 20, 58 },
+    { 58, 59 },
+    { 19, 59 },
+    { 18, 59 },
+    { 59, 60 },
+    { 17, 60 },
+    { 60, 61 },
+    { 16, 61 },
+    { 15, 61 },
+    { 61, 62 },
+    { 62, 63 },
+    { 63, 64 },
+    { 64, 65 },
+    { 65, 66 },
+    { 66, 67 },
+    { 67, 68 },
+    { 68, 69 },
+    { 69, 70 },
+    { 28, 71 },
+    { 71, 72 },
+    { 27, 72 },
+    { 72, 73 },
+    { 26, 73 },
+    { 73, 74 },
+    { 25, 74 },
+    { 74, 75 },
+    { 24, 75 },
+    { 23, 75 },
+    { 75, 76 },
+    { 76, 77 },
+    { 22, 77 },
+    { 21, 78 },
+    { 77, 79 },
+    { 78, 79 },
+    { 79, 80 },
+    { 80, 81 },
+    { 81, 82 },
+    { 82, 83 },
+    { 83, 84 },
+    { 84, 85 },
+    { 85, 86 },
+    { 86, 87 },
+    { 87, 88 },
+    { 88, 66 },
+    { 39, 89 },
+    { 89, 90 },
+    { 38, 90 },
+    { 29, 90 },
+    { 90, 91 },
+    { 37, 91 },
+    { 30, 91 },
+    { 91, 92 },
+    { 31, 92 },
+    { 36, 92 },
+    { 92, 93 },
+    { 32, 93 },
+    { 35, 93 },
+    { 93, 94 },
+    { 33, 94 },
+    { 34, 94 },
+    { 94, 95 },
+    { 95, 96 },
+    { 96, 97 },
+    { 97, 98 },
+    { 99, 100 },
+    { 100, 101 },
+    { 101, 102 },
+    { 102, 103 },
+    { 103, 104 },
+    { 104, 105 },
+    { 105, 106 },
+    { 106, 107 },
+    { 107, 108 },
+    { 108, 82 },
+    { 109, 110 },
+    { 110, 111 },
+    { 111, 112 },
+    { 112, 113 },
+    { 113, 114 },
+    { 114, 115 },
+    { 115, 116 },
+    { 116, 117 },
+    { 117, 118 },
+    { 118, 119 },
+    { 119, 120 },
+    { 120, 121 },
+    { 121, 122 },
+    { 122, 123 },
+
+    /* departure from right */
+    { 123, 124 },
+    { 124, 125 },
+    { 125, 126 },
+    { 126, 127 },
+    { 127, 128 },
+    { 128, 129 },
+    { 129, 130 },
+    { 130, 131 },
+    { 131, 132 },
+    { 132, 133 },
+    { 133, 134 },
+    { 134, 135 },
+    { 135, 136 },
+    { 136, 137 },
+    { 137, 138 },
+    { 138, 139 },
+    { 139, FAKE_POINT },
+
+    /* departure from left */
+    { 57, 70 },
+    { 70, 140 },
+    { 140, 141 },
+    { 141, 142 },
+    { 142, 143 },
+    { 143, 144 },
+    { 144, 145 },
+    { 145, 146 },
+    { 146, 147 },
+    { 147, 148 },
+    { 148, 149 },
+    { 149, 150 },
+    { 150, 151 },
+    { 151, 152 },
+    { 152, 153 },
+    { 153, 154 },
+    { 154, 155 },
+    { 155, FAKE_POINT }
+
+
+
+};
+
+unordered_map<size_t, vector<size_t>> aerodrome_engine::DEPARTURES_VARIADIC_TRAJECTORY = {
+    { 98, { 109, 99 } }
+};
+
+
+unordered_map<size_t, pair<size_t, taxiway_endpoints_t>> aerodrome_engine::TAXIWAY_ENDPOINTS = {
+    { 0, {9, taxiway_endpoints_t::START} },
+    { 1, {9, taxiway_endpoints_t::START} },
+    { 2, {9, taxiway_endpoints_t::START} },
+    { 3, {9, taxiway_endpoints_t::START} },
+    { 4, {9, taxiway_endpoints_t::START} },
+    { 5, {9, taxiway_endpoints_t::START} },
+    { 6, {9, taxiway_endpoints_t::START} },
+    { 7, {9, taxiway_endpoints_t::START} },
+    { 8, {9, taxiway_endpoints_t::START} },
+    { 9, {9, taxiway_endpoints_t::START} },
+    { 10, {9, taxiway_endpoints_t::START} },
+    { 11, {9, taxiway_endpoints_t::START} },
+    { 12, {9, taxiway_endpoints_t::START} },
+    { 13, {9, taxiway_endpoints_t::START} },
+    { 14, {9, taxiway_endpoints_t::START} },
+    { 57, {9, taxiway_endpoints_t::END} },
+    { 46, {0, taxiway_endpoints_t::START} },
+    { FAKE_POINT, {0, taxiway_endpoints_t::END} },
+    { 15, {8, taxiway_endpoints_t::START} },
+    { 16, {8, taxiway_endpoints_t::START} },
+    { 17, {8, taxiway_endpoints_t::START} },
+    { 18, {8, taxiway_endpoints_t::START} },
+    { 19, {8, taxiway_endpoints_t::START} },
+    { 20, {8, taxiway_endpoints_t::START} },
+    { 65, {8, taxiway_endpoints_t::END} },
+    { 64, {1, taxiway_endpoints_t::START} },
+    { 69, {1, taxiway_endpoints_t::END} },
+    { 68, {0, taxiway_endpoints_t::START} },
+    { 21, {7, taxiway_endpoints_t::START} },
+    { 22, {7, taxiway_endpoints_t::START} },
+    { 23, {7, taxiway_endpoints_t::START} },
+    { 24, {7, taxiway_endpoints_t::START} },
+    { 25, {7, taxiway_endpoints_t::START} },
+    { 26, {7, taxiway_endpoints_t::START} },
+    { 27, {7, taxiway_endpoints_t::START} },
+    { 28, {7, taxiway_endpoints_t::START} },
+    { 81, {7, taxiway_endpoints_t::END} },
+    { 80, {10, taxiway_endpoints_t::START} },
+    { 88, {10, taxiway_endpoints_t::END} },
+    { 87, {1, taxiway_endpoints_t::START} },
+    { 29, {6, taxiway_endpoints_t::START} },
+    { 30, {6, taxiway_endpoints_t::START} },
+    { 31, {6, taxiway_endpoints_t::START} },
+    { 32, {6, taxiway_endpoints_t::START} },
+    { 33, {6, taxiway_endpoints_t::START} },
+    { 34, {6, taxiway_endpoints_t::START} },
+    { 35, {6, taxiway_endpoints_t::START} },
+    { 36, {6, taxiway_endpoints_t::START} },
+    { 37, {6, taxiway_endpoints_t::START} },
+    { 38, {6, taxiway_endpoints_t::START} },
+    { 39, {6, taxiway_endpoints_t::START} },
+    { 97, {6, taxiway_endpoints_t::END} },
+    { 96, {10, taxiway_endpoints_t::START} },
+    { 118, {4, taxiway_endpoints_t::START} },
+    { 119, {10, taxiway_endpoints_t::END} },
+    { 122, {0, taxiway_endpoints_t::START} },
+    { 123, {4, taxiway_endpoints_t::END} },
+    { 156, {2, taxiway_endpoints_t::END} },
+    { 157, {0, taxiway_endpoints_t::START} },
+    { 158, {10, taxiway_endpoints_t::END} },
+    { 159, {2, taxiway_endpoints_t::START} }
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <memory_resource>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::size_t;
+using std::unordered_map;
+using std::vector;
+using point_t = pair<double, double>;  // sorry about that
+
+
+namespace detail {
+
+enum class taxiway_endpoints_t {
+    START, END, IGNORE
+};
+
+} // namespace detail
+
+
+// Schedule of the aerodrome: moves departing and arriving aircraft one point per
+// tick and keeps every taxiway used by one aircraft at a time.
+// Persistent state lives in a pool resource and per-tick scratch in a frame arena
+// released at the start of every tick, so a warmed up engine ticks without heap
+// allocations.
+class aerodrome_engine {
+public:
+    using departure_t = pair<size_t, size_t>;
+    using route_t = std::pmr::deque<size_t>;
+    using arrival_t = pair<size_t, route_t>;
+    using taxiway_queue_t = std::pmr::deque<size_t>;
+    using waiting_t = std::pmr::unordered_map<size_t, std::pmr::vector<size_t>>;
+
+    explicit aerodrome_engine(unsigned seed = std::mt19937::default_seed);
+
+    aerodrome_engine(const aerodrome_engine&) = delete;
+    aerodrome_engine& operator=(const aerodrome_engine&) = delete;
+
+    void update_aerodrome();
+
+    void set_plane_number(size_t value);
+    size_t plane_number() const;
+
+    const std::pmr::vector<departure_t>& departures() const;
+    const std::pmr::vector<arrival_t>& arrivals() const;
+    const waiting_t& waiting_arrivals() const;
+    const std::pmr::vector<taxiway_queue_t>& taxiway_queues() const;
+    // point of the special vehicle, FAKE_POINT while it is parked
+    size_t helper_point() const;
+    // its index into HELPER_TRAJECTORY and the direction it moves along it
+    size_t helper_index() const;
+    int helper_delta() const;
+
+    // In a network aircraft are not drawn at random but flown between the
+    // aerodromes: inbound flights land first, landed aircraft park at their
+    // gate and departures take off only with parked aircraft.
+    void set_networked(bool enabled);
+    void add_inbound(size_t flights);
+    void add_parked(size_t aircraft);
+    size_t inbound() const;
+    size_t parked() const;
+    // departures which left the aerodrome during the last tick
+    size_t departed() const;
+    const std::mt19937& random_generator() const;
+
+    // Writes the whole schedule state, generator included, in a compact versioned
+    // format; a restored engine ticks exactly as the saved one would have. The
+    // network counters are not part of it, networked engines are not saved.
+    bool save_state(std::ostream& out) const;
+    // leaves the engine untouched and returns false on a malformed state
+    bool load_state(std::istream& in);
+
+private:
+    size_t random_below(size_t bound);
+    void reserve_pool();
+
+public:
+    constexpr static double maximum_w{1920};
+    constexpr static double maximum_h{1080};
+    constexpr static size_t TAXIWAY_COUNT = 11;
+    // most aircraft the window offers, the headless modes run as many by default
+    constexpr static size_t MAX_PLANE_NUMBER = 10;
+
+    static vector<point_t> POINT_BY_ID;
+    static const size_t FAKE_POINT;
+    static vector<size_t> HELPER_TRAJECTORY;
+    static unordered_map<size_t, size_t> DEPARTURES_TRAJECTORY;
+    static unordered_map<size_t, vector<size_t>> DEPARTURES_VARIADIC_TRAJECTORY;
+    static vector<size_t> SPAWNPOINT;
+    static unordered_map<size_t, pair<size_t, detail::taxiway_endpoints_t>> TAXIWAY_ENDPOINTS;
+
+private:
+    constexpr static size_t FRAME_ARENA_SIZE = 16 * 1024;
+
+    std::pmr::unsynchronized_pool_resource pool;
+    std::array<std::byte, FRAME_ARENA_SIZE> frame_buffer;
+    // overflows of the frame arena are taken from the pool, so they are recycled too
+    std::pmr::monotonic_buffer_resource frame_arena;
+
+    std::mt19937 generator;
+    size_t plane_number_{2};
+    size_t helper_position{0};
+    int helper_position_delta{0};
+    bool networked{false};
+    size_t inbound_flights{0};
+    size_t parked_aircraft{0};
+    size_t departed_flights{0};
+    std::pmr::vector<departure_t> departure_aircrafts;
+    std::pmr::vector<arrival_t> arrival_aircrafts;
+    waiting_t arival_waiting_aircrafts;
+    std::pmr::vector<taxiway_queue_t> taxiway_que;
+};
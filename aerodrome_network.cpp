@@ -0,0 +1,172 @@
+#include "aerodrome_network.h"
+
+#include <algorithm>
+
+
+aerodrome_network::shard_t::shard_t(unsigned seed, size_t id, size_t airports, size_t fleet)
+    : engine(seed + static_cast<unsigned>(id)),
+      grounded(airports)
+{
+    // seeded apart, so destinations do not replay the schedule's numbers
+    std::seed_seq destinations{seed, static_cast<unsigned>(id)};
+    generator.seed(destinations);
+    engine.set_networked(true);
+    engine.add_parked(fleet);
+}
+
+
+aerodrome_network::aerodrome_network(size_t airports, size_t fleet, unsigned seed) {
+    for (size_t id = 0; id != airports; ++id) {
+        shards.push_back(std::make_unique<shard_t>(seed, id, airports, fleet));
+    }
+    for (size_t i = 0; i != airports * airports; ++i) {
+        routes.push_back(std::make_unique<flight_queue_t>());
+    }
+    for (size_t id = 0; id != airports; ++id) {
+        threads.emplace_back(&aerodrome_network::run_shard, this, id);
+    }
+}
+
+aerodrome_network::~aerodrome_network() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batch_started.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+
+void aerodrome_network::update_network(size_t ticks) {
+    while (ticks != 0) {
+        size_t count = std::min(ticks, MIN_FLIGHT_TICKS);
+        std::unique_lock<std::mutex> lock(mutex);
+        batch_first = current_tick;
+        batch_ticks = count;
+        running = shards.size();
+        ++batch;
+        batch_started.notify_all();
+        batch_finished.wait(lock, [&]() { return running == 0; });
+
+        current_tick += count;
+        ticks -= count;
+    }
+}
+
+
+size_t aerodrome_network::size() const {
+    return shards.size();
+}
+
+aerodrome_engine& aerodrome_network::airport(size_t id) {
+    return shards[id]->engine;
+}
+
+const aerodrome_engine& aerodrome_network::airport(size_t id) const {
+    return shards[id]->engine;
+}
+
+void aerodrome_network::set_plane_number(size_t value) {
+    for (auto& shard : shards) {
+        shard->engine.set_plane_number(value);
+    }
+}
+
+
+size_t aerodrome_network::ticks() const {
+    return current_tick;
+}
+
+size_t aerodrome_network::in_flight() const {
+    size_t sent = 0;
+    size_t received = 0;
+    for (auto& shard : shards) {
+        sent += shard->sent;
+        received += shard->received;
+    }
+    return sent - received;
+}
+
+size_t aerodrome_network::flight_ticks(size_t from, size_t to) const {
+    size_t hops = from > to ? from - to : to - from;
+    hops = std::min(hops, shards.size() - hops);
+    return MIN_FLIGHT_TICKS + FLIGHT_TICKS_PER_HOP * hops;
+}
+
+
+void aerodrome_network::run_shard(size_t id) {
+    size_t seen = 0;
+    for (;;) {
+        size_t first;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batch_started.wait(lock, [&]() { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = batch;
+            first = batch_first;
+            count = batch_ticks;
+        }
+
+        for (size_t tick = first; tick != first + count; ++tick) {
+            tick_shard(id, tick);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            batch_finished.notify_one();
+        }
+    }
+}
+
+
+// Flights of one route are queued in landing order, so the first one not due
+// yet ends the landings from that route.
+void aerodrome_network::tick_shard(size_t id, size_t tick) {
+    shard_t& shard = *shards[id];
+
+    size_t landed = 0;
+    for (size_t from = 0; from != shards.size(); ++from) {
+        flight_queue_t& inbound = route(from, id);
+        flight_t flight;
+        while (inbound.front(flight) && flight.landing_tick <= tick) {
+            inbound.pop();
+            ++landed;
+        }
+    }
+    shard.engine.add_inbound(landed);
+    shard.received += landed;
+
+    shard.engine.update_aerodrome();
+
+    // the capacity is far above what a route holds, a full queue only delays a flight
+    for (size_t to = 0; to != shards.size(); ++to) {
+        std::deque<flight_t>& waiting = shard.grounded[to];
+        while (!waiting.empty() && route(id, to).push(waiting.front())) {
+            waiting.pop_front();
+        }
+    }
+
+    for (size_t i = 0; i != shard.engine.departed(); ++i) {
+        size_t to = 0;
+        if (shards.size() > 1) {
+            to = std::uniform_int_distribution<size_t>(0, shards.size() - 2)(shard.generator);
+            to += to >= id ? 1 : 0;
+        }
+
+        flight_t flight{tick + flight_ticks(id, to)};
+        if (!shard.grounded[to].empty() || !route(id, to).push(flight)) {
+            shard.grounded[to].push_back(flight);
+        }
+        ++shard.sent;
+    }
+}
+
+
+aerodrome_network::flight_queue_t& aerodrome_network::route(size_t from, size_t to) {
+    return *routes[from * shards.size() + to];
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+#include "spsc_queue.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Several aerodromes sharing one fleet: every departure lands as an arrival at
+// another aerodrome after a flight time and parks there until it departs
+// again, so the number of aircraft stays the same. Each aerodrome ticks on its
+// own thread and flights are passed through lock-free queues, one per route.
+// A flight takes at least MIN_FLIGHT_TICKS, so within that many ticks no
+// aerodrome depends on the others and they run a whole batch without waiting;
+// the result is the same whatever the threads timing is.
+class aerodrome_network {
+public:
+    constexpr static size_t MIN_FLIGHT_TICKS = 20;
+    constexpr static size_t FLIGHT_TICKS_PER_HOP = 10;
+    // aircraft parked at every aerodrome of a new network
+    constexpr static size_t DEFAULT_FLEET = 10;
+
+    // `fleet` aircraft start parked at every aerodrome
+    aerodrome_network(size_t airports, size_t fleet, unsigned seed = std::mt19937::default_seed);
+    ~aerodrome_network();
+
+    aerodrome_network(const aerodrome_network&) = delete;
+    aerodrome_network& operator=(const aerodrome_network&) = delete;
+
+    // Advances every aerodrome by `ticks` ticks. Aerodromes must not be touched
+    // from other threads meanwhile, between the calls they are free to use.
+    void update_network(size_t ticks = 1);
+
+    size_t size() const;
+    aerodrome_engine& airport(size_t id);
+    const aerodrome_engine& airport(size_t id) const;
+    void set_plane_number(size_t value);
+
+    size_t ticks() const;
+    // flights which took off and have not landed yet
+    size_t in_flight() const;
+    // aerodromes are placed on a ring, farther ones take longer to reach
+    size_t flight_ticks(size_t from, size_t to) const;
+
+private:
+    struct flight_t {
+        size_t landing_tick;
+    };
+
+    constexpr static size_t FLIGHT_QUEUE_CAPACITY = 1024;
+    using flight_queue_t = spsc_queue<flight_t, FLIGHT_QUEUE_CAPACITY>;
+
+    struct shard_t {
+        shard_t(unsigned seed, size_t id, size_t airports, size_t fleet);
+
+        aerodrome_engine engine;
+        // picks destinations, apart from the schedule generator
+        std::mt19937 generator;
+        // flights a full route queue did not take yet, by destination
+        vector<std::deque<flight_t>> grounded;
+        size_t sent{0};
+        size_t received{0};
+    };
+
+    void run_shard(size_t id);
+    void tick_shard(size_t id, size_t tick);
+    flight_queue_t& route(size_t from, size_t to);
+
+private:
+    vector<std::unique_ptr<shard_t>> shards;
+    // route from -> to is routes[from * size() + to]
+    vector<std::unique_ptr<flight_queue_t>> routes;
+    size_t current_tick{0};
+
+    std::mutex mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+    size_t batch{0};
+    size_t batch_first{0};
+    size_t batch_ticks{0};
+    size_t running{0};
+    bool stopping{false};
+    vector<std::thread> threads;
+};
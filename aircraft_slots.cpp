@@ -0,0 +1,79 @@
+#include "aircraft_slots.h"
+
+#include <algorithm>
+
+
+aircraft_slots::aircraft_slots()
+    : previous_point(2 * aerodrome_engine::SPAWNPOINT.size() + 1, aerodrome_engine::FAKE_POINT),
+      current_point(2 * aerodrome_engine::SPAWNPOINT.size() + 1, aerodrome_engine::FAKE_POINT),
+      waited(2 * aerodrome_engine::SPAWNPOINT.size() + 1, 0)
+{}
+
+
+void aircraft_slots::sync(const aerodrome_engine& engine) {
+    previous_point.swap(current_point);
+    std::fill(current_point.begin(), current_point.end(), aerodrome_engine::FAKE_POINT);
+
+    for (auto& [id, point_id] : engine.departures()) {
+        current_point[id] = point_id;
+    }
+    for (auto& [id, steps] : engine.arrivals()) {
+        current_point[aerodrome_engine::SPAWNPOINT.size() + id] = steps.front();
+    }
+    current_point.back() = engine.helper_point();
+
+    for (size_t slot = 0; slot != current_point.size(); ++slot) {
+        bool stays = visible(slot) && current_point[slot] == previous_point[slot];
+        waited[slot] = stays ? waited[slot] + 1 : 0;
+    }
+}
+
+void aircraft_slots::clear() {
+    std::fill(previous_point.begin(), previous_point.end(), aerodrome_engine::FAKE_POINT);
+    std::fill(current_point.begin(), current_point.end(), aerodrome_engine::FAKE_POINT);
+    std::fill(waited.begin(), waited.end(), 0);
+}
+
+
+size_t aircraft_slots::size() const {
+    return current_point.size();
+}
+
+size_t aircraft_slots::helper() const {
+    return current_point.size() - 1;
+}
+
+bool aircraft_slots::arrival(size_t slot) const {
+    return slot >= aerodrome_engine::SPAWNPOINT.size() && slot != helper();
+}
+
+size_t aircraft_slots::aircraft_id(size_t slot) const {
+    return arrival(slot) ? slot - aerodrome_engine::SPAWNPOINT.size() : slot;
+}
+
+
+bool aircraft_slots::visible(size_t slot) const {
+    return current_point[slot] != aerodrome_engine::FAKE_POINT;
+}
+
+size_t aircraft_slots::current(size_t slot) const {
+    return current_point[slot];
+}
+
+size_t aircraft_slots::previous(size_t slot) const {
+    return previous_point[slot];
+}
+
+size_t aircraft_slots::wait_ticks(size_t slot) const {
+    return waited[slot];
+}
+
+
+point_t aircraft_slots::interpolate(size_t slot, double t) const {
+    const point_t& to = aerodrome_engine::POINT_BY_ID[current_point[slot]];
+    if (previous_point[slot] == aerodrome_engine::FAKE_POINT || !visible(slot)) {
+        return to;
+    }
+    const point_t& from = aerodrome_engine::POINT_BY_ID[previous_point[slot]];
+    return {from.first + (to.first - from.first) * t, from.second + (to.second - from.second) * t};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Fixed slot per aircraft of an engine state, so that frames can follow them
+// between ticks. Departures use slots [0, SPAWNPOINT.size()), arrivals the slots
+// after them and the helper the last one: an arrival still waiting at FAKE_POINT
+// may share its id with a new departure. Absent slots hold FAKE_POINT.
+class aircraft_slots {
+public:
+    aircraft_slots();
+
+    // takes the positions after a tick, the current ones become previous
+    void sync(const aerodrome_engine& engine);
+    void clear();
+
+    size_t size() const;
+    size_t helper() const;
+    bool arrival(size_t slot) const;
+    size_t aircraft_id(size_t slot) const;
+
+    bool visible(size_t slot) const;
+    size_t current(size_t slot) const;
+    size_t previous(size_t slot) const;
+    size_t wait_ticks(size_t slot) const;
+    // position between the previous and the current point, t in [0, 1]
+    point_t interpolate(size_t slot, double t) const;
+
+private:
+    vector<size_t> previous_point;
+    vector<size_t> current_point;
+    vector<size_t> waited;
+};
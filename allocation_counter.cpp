@@ -0,0 +1,74 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+namespace {
+
+std::atomic<std::size_t> counter{0};
+
+} // namespace
+
+
+bool allocation_counter::enabled() {
+#ifdef AERODROME_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::size_t allocation_counter::allocations() {
+    return counter.load(std::memory_order_relaxed);
+}
+
+
+#ifdef AERODROME_COUNT_ALLOCATIONS
+
+// the array and nothrow forms fall back to these by default
+void* operator new(std::size_t size) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    if (void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+    void* result = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* result = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    if (result) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
+
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+
+// Test hook counting calls of the global operator new. The counting operators
+// are compiled in only with AERODROME_COUNT_ALLOCATIONS, otherwise nothing is
+// replaced and the counter stays at zero.
+namespace allocation_counter {
+
+bool enabled();
+std::size_t allocations();
+
+} // namespace allocation_counter
@@ -0,0 +1,126 @@
+#include "differential.h"
+
+#include "aerodrome_engine.h"
+#include "reference_engine.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+
+
+bool differential::run(size_t ticks, unsigned seed, size_t plane_number, size_t plane_change_ticks,
+                       divergence_t& divergence) {
+    aerodrome_engine optimized(seed);
+    reference_engine reference(seed);
+    optimized.set_plane_number(plane_number);
+    reference.set_plane_number(plane_number);
+
+    // apart from the engine generators, so both keep drawing the same numbers
+    std::mt19937 planes(seed);
+    std::uniform_int_distribution<size_t> random_plane_number(1, aerodrome_engine::SPAWNPOINT.size());
+
+    for (size_t tick = 0; tick != ticks; ++tick) {
+        if (plane_change_ticks != 0 && tick % plane_change_ticks == plane_change_ticks - 1) {
+            size_t value = random_plane_number(planes);
+            optimized.set_plane_number(value);
+            reference.set_plane_number(value);
+        }
+
+        optimized.update_aerodrome();
+        reference.update_aerodrome();
+
+        bool same_generator = optimized.random_generator() == reference.random_generator();
+        if (same_generator && hash_state(optimized) == hash_state(reference)) {
+            continue;
+        }
+
+        divergence.tick = tick;
+        divergence.diff = diff(describe_state(reference), describe_state(optimized));
+        if (!same_generator) {
+            divergence.diff.push_back("  generators drew a different amount of numbers");
+        }
+        return false;
+    }
+    return true;
+}
+
+
+bool differential::run_restored(size_t ticks, unsigned seed, size_t plane_number, size_t plane_change_ticks,
+                                size_t checkpoint_ticks, divergence_t& divergence) {
+    aerodrome_engine saved(seed);
+    std::unique_ptr<aerodrome_engine> restored;
+    saved.set_plane_number(plane_number);
+
+    std::mt19937 planes(seed);
+    std::uniform_int_distribution<size_t> random_plane_number(1, aerodrome_engine::SPAWNPOINT.size());
+
+    for (size_t tick = 0; tick != ticks; ++tick) {
+        if (checkpoint_ticks != 0 && tick % checkpoint_ticks == 0) {
+            std::stringstream state;
+            restored = std::make_unique<aerodrome_engine>();
+            if (!saved.save_state(state) || !restored->load_state(state)) {
+                divergence.tick = tick;
+                divergence.diff = {"  the saved state was rejected"};
+                return false;
+            }
+        }
+        if (plane_change_ticks != 0 && tick % plane_change_ticks == plane_change_ticks - 1) {
+            size_t value = random_plane_number(planes);
+            saved.set_plane_number(value);
+            if (restored) {
+                restored->set_plane_number(value);
+            }
+        }
+
+        saved.update_aerodrome();
+        if (!restored) {
+            continue;
+        }
+        restored->update_aerodrome();
+
+        bool same_generator = saved.random_generator() == restored->random_generator();
+        if (same_generator && hash_state(saved) == hash_state(*restored)) {
+            continue;
+        }
+
+        divergence.tick = tick;
+        divergence.diff = diff(describe_state(saved), describe_state(*restored));
+        if (!same_generator) {
+            divergence.diff.push_back("  generators drew a different amount of numbers");
+        }
+        return false;
+    }
+    return true;
+}
+
+
+vector<string> differential::diff(const vector<string>& reference, const vector<string>& optimized) {
+    size_t n = reference.size();
+    size_t m = optimized.size();
+
+    // common[i][j] is the longest common subsequence of the suffixes from i and j
+    vector<vector<size_t>> common(n + 1, vector<size_t>(m + 1, 0));
+    for (size_t i = n; i-- != 0;) {
+        for (size_t j = m; j-- != 0;) {
+            common[i][j] = reference[i] == optimized[j]
+                    ? common[i + 1][j + 1] + 1
+                    : std::max(common[i + 1][j], common[i][j + 1]);
+        }
+    }
+
+    vector<string> result;
+    size_t i = 0;
+    size_t j = 0;
+    while (i != n || j != m) {
+        if (i != n && j != m && reference[i] == optimized[j]) {
+            ++i;
+            ++j;
+        } else if (j == m || (i != n && common[i + 1][j] >= common[i][j + 1])) {
+            result.push_back("- " + reference[i++]);
+        } else {
+            result.push_back("+ " + optimized[j++]);
+        }
+    }
+    return result;
+}
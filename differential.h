@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+
+// Lockstep comparison of aerodrome_engine with the frozen reference_engine, or
+// with itself restored from a checkpoint. Both engines are started from one
+// state and the full state of both is hashed after every tick; on the first
+// mismatch the states are listed line by line and the differing lines reported.
+namespace differential {
+
+struct divergence_t {
+    size_t tick{0};
+    // lines of the reference state prefixed with "- ", of the optimized one with "+ "
+    vector<string> diff;
+};
+
+// Runs `ticks` ticks, changing the plane number of both engines to a random one
+// every `plane_change_ticks` ticks unless it is 0. False on a divergence.
+bool run(size_t ticks, unsigned seed, size_t plane_number, size_t plane_change_ticks, divergence_t& divergence);
+
+// Runs `ticks` ticks the same way, saving the state every `checkpoint_ticks` ticks
+// and restoring it into a new engine ticked in lockstep from then on, with
+// "- " lines of the saved engine and "+ " of the restored one. False when a
+// saved state is rejected or the restored engine diverges.
+bool run_restored(size_t ticks, unsigned seed, size_t plane_number, size_t plane_change_ticks,
+                  size_t checkpoint_ticks, divergence_t& divergence);
+
+// Hash and listing of the full state, generator excluded, of either engine:
+// the helper by its trajectory index and direction, since its point is
+// FAKE_POINT at both ends, and the network counters too. Waiting arrivals are
+// taken in their iteration order, which decides the order they are tried in.
+template <typename engine_t>
+std::uint64_t hash_state(const engine_t& engine);
+template <typename engine_t>
+vector<string> describe_state(const engine_t& engine);
+
+// lines of `reference` and `optimized` not on their longest common subsequence
+vector<string> diff(const vector<string>& reference, const vector<string>& optimized);
+
+} // namespace differential
+
+
+namespace detail {
+
+// FNV-1a over 64 bit words
+class state_hash {
+public:
+    void add(std::uint64_t word) {
+        for (int i = 0; i != 8; ++i) {
+            value = (value ^ ((word >> (8 * i)) & 0xff)) * 0x100000001b3ull;
+        }
+    }
+
+    template <typename container_t>
+    void add_all(const container_t& words) {
+        add(words.size());
+        for (auto word : words) {
+            add(word);
+        }
+    }
+
+    std::uint64_t result() const {
+        return value;
+    }
+
+private:
+    std::uint64_t value{0xcbf29ce484222325ull};
+};
+
+template <typename container_t>
+string join(const container_t& words) {
+    string result;
+    for (auto word : words) {
+        result += ' ' + std::to_string(word);
+    }
+    return result;
+}
+
+} // namespace detail
+
+
+template <typename engine_t>
+std::uint64_t differential::hash_state(const engine_t& engine) {
+    detail::state_hash hash;
+    hash.add(engine.plane_number());
+    hash.add(engine.helper_index());
+    hash.add(static_cast<std::uint64_t>(engine.helper_delta()));
+    hash.add(engine.inbound());
+    hash.add(engine.parked());
+    hash.add(engine.departed());
+
+    hash.add(engine.departures().size());
+    for (auto& [id, point_id] : engine.departures()) {
+        hash.add(id);
+        hash.add(point_id);
+    }
+    hash.add(engine.arrivals().size());
+    for (auto& [id, steps] : engine.arrivals()) {
+        hash.add(id);
+        hash.add_all(steps);
+    }
+    hash.add(engine.waiting_arrivals().size());
+    for (auto& [id, taxiways_needed] : engine.waiting_arrivals()) {
+        hash.add(id);
+        hash.add_all(taxiways_needed);
+    }
+    for (auto& que : engine.taxiway_queues()) {
+        hash.add_all(que);
+    }
+    return hash.result();
+}
+
+
+template <typename engine_t>
+vector<string> differential::describe_state(const engine_t& engine) {
+    vector<string> lines;
+    lines.push_back("plane number " + std::to_string(engine.plane_number()));
+    lines.push_back("helper at " + std::to_string(engine.helper_index()) + " moving "
+                    + std::to_string(engine.helper_delta()) + ", point " + std::to_string(engine.helper_point()));
+    lines.push_back("network " + std::to_string(engine.inbound()) + " inbound, " + std::to_string(engine.parked())
+                    + " parked, " + std::to_string(engine.departed()) + " departed");
+
+    for (auto& [id, point_id] : engine.departures()) {
+        lines.push_back("departure " + std::to_string(id) + " at " + std::to_string(point_id));
+    }
+    for (auto& [id, steps] : engine.arrivals()) {
+        lines.push_back("arrival " + std::to_string(id) + " route" + detail::join(steps));
+    }
+    for (auto& [id, taxiways_needed] : engine.waiting_arrivals()) {
+        lines.push_back("waiting " + std::to_string(id) + " for taxiways" + detail::join(taxiways_needed));
+    }
+    for (size_t way = 0; way != engine.taxiway_queues().size(); ++way) {
+        lines.push_back("taxiway " + std::to_string(way) + " queue" + detail::join(engine.taxiway_queues()[way]));
+    }
+    return lines;
+}
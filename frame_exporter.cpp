@@ -0,0 +1,218 @@
+#include "frame_exporter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+
+frame_exporter::frame_exporter(const options_t& options)
+    : options(options),
+      engine(options.seed),
+      fleet(options.seed),
+      renderer(pyramid)
+{}
+
+frame_exporter::~frame_exporter() {
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+
+bool frame_exporter::run() {
+    if (stream()) {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        output_stream = stdout;
+    } else if (!QDir().mkpath(options.output)) {
+        std::cerr << "can not create " << options.output.toStdString() << std::endl;
+        return false;
+    }
+
+    engine.set_plane_number(options.plane_number);
+    if (!options.checkpoint.isEmpty()) {
+        QFile file(options.checkpoint);
+        QByteArray state = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+        std::istringstream in(std::string(state.constData(), static_cast<size_t>(state.size())));
+        if (!engine.load_state(in)) {
+            std::cerr << "can not load " << options.checkpoint.toStdString() << std::endl;
+            return false;
+        }
+        aircraft.sync(engine);
+    }
+
+    pyramid.build(QImage(":/src/img/aerodrom-satellite.png"));
+    renderer.resize(options.size);
+    fleet.resize(options.vehicle_number);
+
+    size_t worker_count = options.workers ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    in_flight = worker_count * FRAMES_PER_WORKER;
+    results.assign(in_flight, result_t{});
+    for (size_t i = 0; i != worker_count; ++i) {
+        workers.emplace_back(&frame_exporter::work, this);
+    }
+    writer = std::thread(&frame_exporter::write, this);
+
+    // the window shows nothing before the first tick, so it is taken before the first frame
+    size_t ticks = 0;
+    for (size_t frame = 0; frame != options.frames; ++frame) {
+        double time = static_cast<double>(frame) / options.fps * options.tick_rate;
+        for (size_t tick = static_cast<size_t>(time) + 1; ticks < tick; ++ticks) {
+            engine.update_aerodrome();
+            aircraft.sync(engine);
+        }
+
+        if (frame != 0) {
+            fleet.step(static_cast<float>(options.tick_rate / options.fps));
+        }
+
+        job_t job{frame, {}};
+        collect_marks(time - std::floor(time), job.marks);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        frame_written.wait(lock, [&]() { return failed || frame < written + in_flight; });
+        if (failed) {
+            break;
+        }
+        jobs.push_back(std::move(job));
+        job_added.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    job_added.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    writer.join();
+
+    if (output_stream) {
+        std::fflush(output_stream);
+    }
+    return !failed;
+}
+
+
+// Same order as the window: service vehicles go first to stay under the aircraft.
+void frame_exporter::collect_marks(double progress, vector<radar_renderer::mark_t>& marks) const {
+    for (size_t vehicle = 0; vehicle != fleet.size(); ++vehicle) {
+        marks.push_back({radar_renderer::mark_kind_t::HELPER, {fleet.x(vehicle), fleet.y(vehicle)}});
+    }
+    if (aircraft.visible(aircraft.helper())) {
+        marks.push_back({radar_renderer::mark_kind_t::HELPER, aircraft.interpolate(aircraft.helper(), progress)});
+    }
+    for (size_t slot = 0; slot != aircraft.helper(); ++slot) {
+        if (aircraft.visible(slot)) {
+            marks.push_back({radar_renderer::kind_of(aircraft, slot), aircraft.interpolate(slot, progress)});
+        }
+    }
+}
+
+
+void frame_exporter::work() {
+    QImage frame(options.size, QImage::Format_ARGB32_Premultiplied);
+    const QRectF view(0, 0, aerodrome_engine::maximum_w, aerodrome_engine::maximum_h);
+
+    for (;;) {
+        job_t job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job_added.wait(lock, [&]() { return !jobs.empty() || finished; });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        frame.fill(Qt::black);
+        QPainter painter(&frame);
+        renderer.render(painter, view, job.marks);
+        painter.end();
+        QByteArray data = encode(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result_t& result = results[job.frame % in_flight];
+            result.data = std::move(data);
+            result.ready = true;
+        }
+        result_added.notify_all();
+    }
+}
+
+
+void frame_exporter::write() {
+    for (size_t frame = 0; frame != options.frames; ++frame) {
+        result_t& result = results[frame % in_flight];
+        QByteArray data;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            result_added.wait(lock, [&]() { return result.ready; });
+            data.swap(result.data);
+            result.ready = false;
+        }
+
+        bool done = false;
+        if (stream()) {
+            done = std::fwrite(data.constData(), 1, static_cast<size_t>(data.size()), output_stream)
+                    == static_cast<size_t>(data.size());
+        } else {
+            QFile file(QDir(options.output).filePath(QString("frame_%1.png").arg(frame, 6, 10, QChar('0'))));
+            done = file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done) {
+                written = frame + 1;
+            } else {
+                failed = true;
+            }
+        }
+        frame_written.notify_one();
+        if (!done) {
+            std::cerr << "can not write frame " << frame << std::endl;
+            return;
+        }
+    }
+}
+
+
+QByteArray frame_exporter::encode(const QImage& frame) const {
+    if (stream()) {
+        QImage rgba = frame.convertToFormat(QImage::Format_RGBA8888);
+        return QByteArray(reinterpret_cast<const char*>(rgba.constBits()), static_cast<int>(rgba.sizeInBytes()));
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    frame.save(&buffer, "PNG");
+    return data;
+}
+
+
+bool frame_exporter::stream() const {
+    return options.output == "-";
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+#include "aircraft_slots.h"
+#include "ground_fleet.h"
+#include "radar_renderer.h"
+#include "tile_pyramid.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <QByteArray>
+#include <QSize>
+#include <QString>
+#include <random>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Renders the schedule offscreen into numbered PNG files or a raw RGBA stream.
+// The simulation runs on the calling thread, frames are painted and encoded by a
+// pool of workers and written strictly in order by a writer thread; at most a
+// couple of frames per worker are in flight, so memory stays bounded.
+class frame_exporter {
+public:
+    struct options_t {
+        // directory for frame_NNNNNN.png files, "-" streams raw RGBA frames to stdout
+        QString output;
+        size_t frames{300};
+        QSize size{1920, 1080};
+        double fps{30};
+        // scheduler ticks per second of the exported video
+        double tick_rate{1};
+        size_t plane_number{2};
+        size_t vehicle_number{0};
+        unsigned seed{std::mt19937::default_seed};
+        // 0 uses every hardware thread
+        size_t workers{0};
+        // saved schedule to start from instead of an empty aerodrome, its plane
+        // number replaces plane_number
+        QString checkpoint;
+    };
+
+    explicit frame_exporter(const options_t& options);
+    ~frame_exporter();
+
+    frame_exporter(const frame_exporter&) = delete;
+    frame_exporter& operator=(const frame_exporter&) = delete;
+
+    // false when the output can not be opened or written
+    bool run();
+
+private:
+    struct job_t {
+        size_t frame;
+        vector<radar_renderer::mark_t> marks;
+    };
+
+    struct result_t {
+        bool ready{false};
+        QByteArray data;
+    };
+
+    void collect_marks(double progress, vector<radar_renderer::mark_t>& marks) const;
+    void work();
+    void write();
+    QByteArray encode(const QImage& frame) const;
+    bool stream() const;
+
+private:
+    options_t options;
+    aerodrome_engine engine;
+    aircraft_slots aircraft;
+    ground_fleet fleet;
+    tile_pyramid pyramid;
+    radar_renderer renderer;
+
+    std::mutex mutex;
+    std::condition_variable job_added;
+    std::condition_variable result_added;
+    std::condition_variable frame_written;
+    std::deque<job_t> jobs;
+    // results by frame % in_flight, waiting for the writer
+    vector<result_t> results;
+    size_t in_flight{0};
+    size_t written{0};
+    bool finished{false};
+    bool failed{false};
+
+    std::FILE* output_stream{nullptr};
+    vector<std::thread> workers;
+    std::thread writer;
+
+    constexpr static size_t FRAMES_PER_WORKER = 2;
+};
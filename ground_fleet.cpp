@@ -0,0 +1,221 @@
+#include "ground_fleet.h"
+
+#include "simd_lanes.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+ground_fleet::ground_fleet(unsigned seed)
+    : generator(seed),
+      node_first(LANE_NODES.size() + 1, 0)
+{
+    for (auto [from, to] : LANES) {
+        for (auto [a, b] : {pair<size_t, size_t>{from, to}, pair<size_t, size_t>{to, from}}) {
+            edge_from.push_back(a);
+            edge_to.push_back(b);
+            edge_length.push_back(static_cast<float>(std::hypot(LANE_NODES[b].first - LANE_NODES[a].first,
+                                                                LANE_NODES[b].second - LANE_NODES[a].second)));
+            ++node_first[a + 1];
+        }
+    }
+
+    // outgoing edges grouped by node, so a vehicle at a node looks at a single range
+    for (size_t node = 0; node != LANE_NODES.size(); ++node) {
+        node_first[node + 1] += node_first[node];
+    }
+    node_edges.resize(edge_from.size());
+    vector<size_t> filled(node_first.begin(), node_first.end() - 1);
+    for (size_t id = 0; id != edge_from.size(); ++id) {
+        node_edges[filled[edge_from[id]]++] = id;
+    }
+}
+
+
+void ground_fleet::resize(size_t new_vehicles) {
+    size_t old_vehicles = vehicles;
+    vehicles = new_vehicles;
+    padded = detail::round_up(new_vehicles, LANE);
+
+    // padding lanes stay parked with zero speed
+    edge.resize(padded, 0);
+    origin_x.resize(padded, 0);
+    origin_y.resize(padded, 0);
+    direction_x.resize(padded, 0);
+    direction_y.resize(padded, 0);
+    length.resize(padded, 0);
+    distance.resize(padded, 0);
+    speed.resize(padded, 0);
+    position_x.resize(padded, 0);
+    position_y.resize(padded, 0);
+
+    std::uniform_real_distribution<float> random_speed(MIN_SPEED, MAX_SPEED);
+    std::uniform_real_distribution<float> random_part(0, 1);
+    for (size_t vehicle = old_vehicles; vehicle < new_vehicles; ++vehicle) {
+        size_t id = std::uniform_int_distribution<size_t>(0, edge_from.size() - 1)(generator);
+        speed[vehicle] = random_speed(generator);
+        place(vehicle, id, random_part(generator) * edge_length[id]);
+    }
+    for (size_t vehicle = new_vehicles; vehicle < padded; ++vehicle) {
+        speed[vehicle] = 0;
+    }
+    position_kernel();
+}
+
+size_t ground_fleet::size() const {
+    return vehicles;
+}
+
+
+void ground_fleet::step(float dt) {
+    advance_kernel(dt);
+
+    for (size_t vehicle = 0; vehicle != vehicles; ++vehicle) {
+        // one step may pass several short lanes
+        while (distance[vehicle] >= length[vehicle]) {
+            float left = distance[vehicle] - length[vehicle];
+            place(vehicle, next_edge(edge[vehicle]), left);
+        }
+    }
+
+    position_kernel();
+}
+
+
+float ground_fleet::x(size_t vehicle) const {
+    return position_x[vehicle];
+}
+
+float ground_fleet::y(size_t vehicle) const {
+    return position_y[vehicle];
+}
+
+
+void ground_fleet::place(size_t vehicle, size_t id, float along) {
+    const point_t& from = LANE_NODES[edge_from[id]];
+    const point_t& to = LANE_NODES[edge_to[id]];
+    float span = edge_length[id];
+
+    edge[vehicle] = static_cast<std::uint32_t>(id);
+    origin_x[vehicle] = static_cast<float>(from.first);
+    origin_y[vehicle] = static_cast<float>(from.second);
+    direction_x[vehicle] = static_cast<float>(to.first - from.first) / span;
+    direction_y[vehicle] = static_cast<float>(to.second - from.second) / span;
+    length[vehicle] = span;
+    distance[vehicle] = along;
+}
+
+
+// Vehicles turn back only at dead ends.
+size_t ground_fleet::next_edge(size_t id) {
+    size_t node = edge_to[id];
+    size_t first = node_first[node];
+    size_t count = node_first[node + 1] - first;
+    if (count == 1) {
+        return node_edges[first];
+    }
+
+    size_t choice = std::uniform_int_distribution<size_t>(0, count - 2)(generator);
+    for (size_t i = first; i != first + count; ++i) {
+        if (node_edges[i] == (id ^ 1)) {
+            continue;
+        }
+        if (choice-- == 0) {
+            return node_edges[i];
+        }
+    }
+    return id ^ 1;
+}
+
+
+void ground_fleet::advance_kernel(float dt) {
+    float* s = distance.data();
+    const float* v = speed.data();
+    size_t i = 0;
+
+#ifdef AERODROME_SSE
+    const __m128 step = _mm_set1_ps(dt);
+    for (; i + LANE <= padded; i += LANE) {
+        __m128 si = _mm_loadu_ps(s + i);
+        __m128 vi = _mm_loadu_ps(v + i);
+        _mm_storeu_ps(s + i, _mm_add_ps(si, _mm_mul_ps(vi, step)));
+    }
+#endif
+    for (; i != padded; ++i) {
+        s[i] += v[i] * dt;
+    }
+}
+
+
+void ground_fleet::position_kernel() {
+    const float* s = distance.data();
+    const float* ox = origin_x.data();
+    const float* oy = origin_y.data();
+    const float* dx = direction_x.data();
+    const float* dy = direction_y.data();
+    float* px = position_x.data();
+    float* py = position_y.data();
+    size_t i = 0;
+
+#ifdef AERODROME_SSE
+    for (; i + LANE <= padded; i += LANE) {
+        __m128 si = _mm_loadu_ps(s + i);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(ox + i), _mm_mul_ps(_mm_loadu_ps(dx + i), si)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(oy + i), _mm_mul_ps(_mm_loadu_ps(dy + i), si)));
+    }
+#endif
+    for (; i != padded; ++i) {
+        px[i] = ox[i] + dx[i] * s[i];
+        py[i] = oy[i] + dy[i] * s[i];
+    }
+}
+
+
+vector<point_t> ground_fleet::LANE_NODES = {
+    /* along the helper trajectory */
+    {1756, 454},
+    {1720, 505},
+    {1720, 587},
+    {1722, 671},
+    {1721, 728},
+    {1658, 765},
+
+    /* behind gates 0 - 8 */
+    {1772, 470},
+    {1772, 400},
+    {1772, 330},
+    {1772, 250},
+
+    /* behind gates 9 - 14 */
+    {1668, 300},
+    {1668, 425},
+    {1700, 232},
+    {1690, 470},
+
+    /* behind gates 15 - 20 */
+    {1665, 805},
+    {1600, 805},
+    {1535, 805},
+
+    /* behind gates 21 - 39 */
+    {1470, 812},
+    {1390, 818},
+    {1300, 812},
+    {1240, 845},
+    {1150, 808},
+    {1090, 808},
+
+    /* depots */
+    {1765, 600},
+    {1060, 840}
+};
+
+
+vector<pair<size_t, size_t>> ground_fleet::LANES = {
+    {0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5},
+    {0, 6}, {6, 7}, {7, 8}, {8, 9},
+    {9, 12}, {12, 10}, {10, 11}, {11, 13}, {13, 1},
+    {5, 14}, {14, 15}, {15, 16},
+    {16, 17}, {17, 18}, {18, 19}, {19, 20}, {20, 21}, {21, 22},
+    {2, 23}, {22, 24}
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::size_t;
+using std::vector;
+
+
+// Ground service vehicles driving on their own network of service lanes.
+// The fleet neither reads nor changes the aircraft schedule, so service vehicles
+// never constrain aircraft, and it has its own random generator, so the schedule
+// stays the same whatever the fleet size is. Per-vehicle data is stored as
+// struct-of-arrays padded to the SIMD width: step() advances all vehicles in
+// one batch and only the few reaching a lane node are handled one by one.
+class ground_fleet {
+public:
+    constexpr static size_t LANE = 4;
+
+    explicit ground_fleet(unsigned seed = std::mt19937::default_seed);
+
+    // new vehicles start at random places of the lane network
+    void resize(size_t vehicles);
+    size_t size() const;
+
+    // dt is measured in scheduler ticks
+    void step(float dt);
+
+    float x(size_t vehicle) const;
+    float y(size_t vehicle) const;
+
+private:
+    void place(size_t vehicle, size_t edge, float distance);
+    size_t next_edge(size_t edge);
+    void advance_kernel(float dt);
+    void position_kernel();
+
+public:
+    // lane nodes are in maximum_w x maximum_h coordinates, lanes are two-way
+    static vector<point_t> LANE_NODES;
+    static vector<pair<size_t, size_t>> LANES;
+
+private:
+    // vehicle speeds in source pixels per scheduler tick
+    constexpr static float MIN_SPEED = 20;
+    constexpr static float MAX_SPEED = 60;
+
+    std::mt19937 generator;
+    size_t vehicles{0};
+    size_t padded{0};
+
+    // directed edges: 2 * lane goes from the first node, 2 * lane + 1 back, so
+    // edge ^ 1 is the reverse one
+    vector<size_t> edge_from;
+    vector<size_t> edge_to;
+    vector<float> edge_length;
+    // outgoing edges of node n are node_edges[node_first[n]..node_first[n + 1])
+    vector<size_t> node_first;
+    vector<size_t> node_edges;
+
+    // per-vehicle edge description
+    vector<std::uint32_t> edge;
+    vector<float> origin_x;
+    vector<float> origin_y;
+    vector<float> direction_x;
+    vector<float> direction_y;
+    vector<float> length;
+
+    // per-vehicle motion state
+    vector<float> distance;
+    vector<float> speed;
+    vector<float> position_x;
+    vector<float> position_y;
+};
@@ -0,0 +1,317 @@
+#include "headless.h"
+
+#include "aerodrome_engine.h"
+#include "aerodrome_network.h"
+#include "aircraft_slots.h"
+#include "allocation_counter.h"
+#include "differential.h"
+#include "frame_exporter.h"
+#include "kinematic_model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+
+
+namespace {
+
+constexpr std::size_t PLANE_CHANGE_TICKS = 1'000;
+constexpr std::size_t CHECKPOINT_TICKS = 1'000;
+// frames of the window per tick at the standard speed
+constexpr std::size_t FRAMES_PER_TICK = 60;
+
+// --planes and --seed, taken by every mode
+struct settings_t {
+    std::size_t plane_number{aerodrome_engine::MAX_PLANE_NUMBER};
+    unsigned seed{std::mt19937::default_seed};
+};
+
+// Reads a mode's command line: `numbers` are its unsigned positional arguments
+// from argv[first] on, `--name value` pairs follow them. --planes and --seed go
+// to `settings`, the plane number clamped to the SPAWNPOINT.size() aircraft the
+// schedule has spawn points for; any other name goes to `option`, which returns
+// false for names the mode does not take and may throw on a bad value. False
+// when the command line is malformed.
+template<typename Option>
+bool parse(int argc, char* argv[], int first, std::initializer_list<std::size_t*> numbers,
+           settings_t& settings, Option option) {
+    int pairs = first + static_cast<int>(numbers.size());
+    if (argc < pairs || (argc - pairs) % 2 != 0) {
+        return false;
+    }
+    try {
+        for (std::size_t* number : numbers) {
+            *number = std::stoul(argv[first++]);
+        }
+        for (int i = pairs; i != argc; i += 2) {
+            std::string value = argv[i + 1];
+            if (std::strcmp(argv[i], "--planes") == 0) {
+                settings.plane_number = std::min<std::size_t>(std::stoul(value), aerodrome_engine::SPAWNPOINT.size());
+            } else if (std::strcmp(argv[i], "--seed") == 0) {
+                settings.seed = static_cast<unsigned>(std::stoul(value));
+            } else if (!option(argv[i], value)) {
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool parse(int argc, char* argv[], int first, std::initializer_list<std::size_t*> numbers, settings_t& settings) {
+    return parse(argc, argv, first, numbers, settings, [](const char*, const std::string&) -> bool {
+        return false;
+    });
+}
+
+int usage() {
+    std::cerr << "usage: --export DIR|- [--frames N] [--size WxH] [--fps F] [--tick-rate T]\n"
+                 "                      [--planes P] [--vehicles V] [--seed S] [--workers W]\n"
+                 "                      [--checkpoint FILE]\n"
+                 "writes DIR/frame_NNNNNN.png, or raw RGBA frames to stdout for -" << std::endl;
+    return 2;
+}
+
+} // namespace
+
+
+int headless::check_allocations(int argc, char* argv[]) {
+    std::size_t ticks = 0;
+    settings_t settings;
+    settings.plane_number = aerodrome_engine::SPAWNPOINT.size();
+    if (!parse(argc, argv, 2, {&ticks}, settings)) {
+        std::cerr << "usage: --check-allocations TICKS [--planes P] [--seed S]" << std::endl;
+        return 2;
+    }
+    if (!allocation_counter::enabled()) {
+        std::cerr << "allocation counting is off, configure with -DAERODROME_COUNT_ALLOCATIONS=ON" << std::endl;
+        return 2;
+    }
+
+    aerodrome_engine engine(settings.seed);
+    engine.set_plane_number(settings.plane_number);
+    for (std::size_t i = 0; i != ticks; ++i) {
+        engine.update_aerodrome();
+    }
+
+    std::size_t before = allocation_counter::allocations();
+    for (std::size_t i = 0; i != ticks; ++i) {
+        engine.update_aerodrome();
+    }
+    std::size_t allocations = allocation_counter::allocations() - before;
+
+    std::cout << allocations << " heap allocations in " << ticks << " ticks" << std::endl;
+    return allocations == 0 ? 0 : 1;
+}
+
+
+int headless::check_separation(int argc, char* argv[]) {
+    std::size_t ticks = 0;
+    std::size_t frames = FRAMES_PER_TICK;
+    settings_t settings;
+    bool parsed = parse(argc, argv, 2, {&ticks}, settings, [&](const char* name, const std::string& value) -> bool {
+        if (std::strcmp(name, "--frames") == 0) {
+            frames = std::stoul(value);
+            return true;
+        }
+        return false;
+    });
+    if (!parsed || frames == 0) {
+        std::cerr << "usage: --check-separation TICKS [--planes P] [--seed S] [--frames F]" << std::endl;
+        return 2;
+    }
+
+    aerodrome_engine engine(settings.seed);
+    engine.set_plane_number(settings.plane_number);
+    aircraft_slots aircraft;
+    kinematic_model kinematics(aircraft.size());
+
+    // two aircraft on their way, and any two slots with the parked ones and the helper
+    float moving = INFINITY;
+    float closest = INFINITY;
+    for (std::size_t tick = 0; tick != ticks; ++tick) {
+        engine.update_aerodrome();
+        aircraft.sync(engine);
+        kinematics.follow(aircraft);
+
+        for (std::size_t frame = 0; frame != frames; ++frame) {
+            kinematics.step(1.0f / static_cast<float>(frames));
+            for (std::size_t i = 0; i != kinematics.size(); ++i) {
+                for (std::size_t j = i + 1; kinematics.active(i) && j != kinematics.size(); ++j) {
+                    if (!kinematics.active(j)) {
+                        continue;
+                    }
+                    float distance = std::hypot(kinematics.x(i) - kinematics.x(j), kinematics.y(i) - kinematics.y(j));
+                    closest = std::min(closest, distance);
+                    if (i != aircraft.helper() && j != aircraft.helper()
+                        && !kinematics.arrived(i) && !kinematics.arrived(j)) {
+                        moving = std::min(moving, distance);
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "closest moving aircraft " << moving << " apart in " << ticks * frames << " steps, "
+              << "separation " << kinematics.separation_distance() << ", any two " << closest << " apart" << std::endl;
+    return moving + 1e-3f >= kinematics.separation_distance() ? 0 : 1;
+}
+
+
+int headless::export_frames(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage();
+    }
+
+    frame_exporter::options_t options;
+    options.output = argv[2];
+    settings_t settings;
+    settings.plane_number = options.plane_number;
+    settings.seed = options.seed;
+    bool parsed = parse(argc, argv, 3, {}, settings, [&](const char* name, const std::string& value) -> bool {
+        if (std::strcmp(name, "--frames") == 0) {
+            options.frames = std::stoul(value);
+        } else if (std::strcmp(name, "--size") == 0) {
+            std::size_t separator = value.find('x');
+            options.size = QSize(std::stoi(value.substr(0, separator)), std::stoi(value.substr(separator + 1)));
+        } else if (std::strcmp(name, "--fps") == 0) {
+            options.fps = std::stod(value);
+        } else if (std::strcmp(name, "--tick-rate") == 0) {
+            options.tick_rate = std::stod(value);
+        } else if (std::strcmp(name, "--vehicles") == 0) {
+            options.vehicle_number = std::stoul(value);
+        } else if (std::strcmp(name, "--workers") == 0) {
+            options.workers = std::stoul(value);
+        } else if (std::strcmp(name, "--checkpoint") == 0) {
+            options.checkpoint = QString::fromStdString(value);
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (!parsed || options.size.isEmpty() || options.fps <= 0 || options.tick_rate <= 0) {
+        return usage();
+    }
+    options.plane_number = settings.plane_number;
+    options.seed = settings.seed;
+
+    frame_exporter exporter(options);
+    return exporter.run() ? 0 : 1;
+}
+
+
+int headless::save_checkpoint(int argc, char* argv[]) {
+    std::size_t ticks = 0;
+    settings_t settings;
+    if (!parse(argc, argv, 3, {&ticks}, settings)) {
+        std::cerr << "usage: --save-checkpoint FILE TICKS [--planes P] [--seed S]" << std::endl;
+        return 2;
+    }
+
+    aerodrome_engine engine(settings.seed);
+    engine.set_plane_number(settings.plane_number);
+    for (std::size_t i = 0; i != ticks; ++i) {
+        engine.update_aerodrome();
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out || !engine.save_state(out)) {
+        std::cerr << "can not write " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+int headless::benchmark_network(int argc, char* argv[]) {
+    std::size_t airports = 0;
+    std::size_t ticks = 0;
+    settings_t settings;
+    if (!parse(argc, argv, 2, {&airports, &ticks}, settings) || airports == 0) {
+        std::cerr << "usage: --benchmark-network AIRPORTS TICKS [--planes P] [--seed S]" << std::endl;
+        return 2;
+    }
+
+    aerodrome_network network(airports, aerodrome_network::DEFAULT_FLEET, settings.seed);
+    network.set_plane_number(settings.plane_number);
+
+    auto start = std::chrono::steady_clock::now();
+    network.update_network(ticks);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << airports << " aerodromes, " << ticks << " ticks in " << elapsed.count() << " s, "
+              << static_cast<double>(airports * ticks) / elapsed.count() << " aerodrome ticks/s, "
+              << network.in_flight() << " flights in the air" << std::endl;
+    return 0;
+}
+
+
+int headless::check_differential(int argc, char* argv[]) {
+    std::size_t ticks = 0;
+    std::size_t plane_change_ticks = PLANE_CHANGE_TICKS;
+    settings_t settings;
+    bool parsed = parse(argc, argv, 2, {&ticks}, settings, [&](const char* name, const std::string& value) -> bool {
+        if (std::strcmp(name, "--plane-change") == 0) {
+            plane_change_ticks = std::stoul(value);
+            return true;
+        }
+        return false;
+    });
+    if (!parsed) {
+        std::cerr << "usage: --differential TICKS [--planes P] [--seed S] [--plane-change N]" << std::endl;
+        return 2;
+    }
+
+    differential::divergence_t divergence;
+    if (differential::run(ticks, settings.seed, settings.plane_number, plane_change_ticks, divergence)) {
+        std::cout << "identical for " << ticks << " ticks" << std::endl;
+        return 0;
+    }
+
+    std::cout << "diverged at tick " << divergence.tick << " (- reference, + optimized):" << std::endl;
+    for (const std::string& line : divergence.diff) {
+        std::cout << line << std::endl;
+    }
+    return 1;
+}
+
+
+int headless::check_checkpoints(int argc, char* argv[]) {
+    std::size_t ticks = 0;
+    std::size_t plane_change_ticks = PLANE_CHANGE_TICKS;
+    std::size_t checkpoint_ticks = CHECKPOINT_TICKS;
+    settings_t settings;
+    bool parsed = parse(argc, argv, 2, {&ticks}, settings, [&](const char* name, const std::string& value) -> bool {
+        if (std::strcmp(name, "--plane-change") == 0) {
+            plane_change_ticks = std::stoul(value);
+        } else if (std::strcmp(name, "--interval") == 0) {
+            checkpoint_ticks = std::stoul(value);
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (!parsed || checkpoint_ticks == 0) {
+        std::cerr << "usage: --check-checkpoints TICKS [--planes P] [--seed S] [--plane-change N] [--interval I]" << std::endl;
+        return 2;
+    }
+
+    differential::divergence_t divergence;
+    if (differential::run_restored(ticks, settings.seed, settings.plane_number, plane_change_ticks, checkpoint_ticks, divergence)) {
+        std::cout << "restored engines identical for " << ticks << " ticks" << std::endl;
+        return 0;
+    }
+
+    std::cout << "diverged at tick " << divergence.tick << " (- saved, + restored):" << std::endl;
+    for (const std::string& line : divergence.diff) {
+        std::cout << line << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+
+// Modes running the engine without a window, selected from the command line.
+// Every mode takes --planes P, at most the SPAWNPOINT.size() aircraft the
+// schedule has spawn points for, and --seed S.
+namespace headless {
+
+// Warms an engine up for `--check-allocations TICKS [--planes P] [--seed S]`
+// ticks and counts the heap allocations made during the next TICKS ticks, at
+// SPAWNPOINT.size() planes unless P is given. Fails unless the count is zero.
+int check_allocations(int argc, char* argv[]);
+
+// Drives the kinematic model from `--check-separation TICKS [--planes P]
+// [--seed S] [--frames F]` ticks of an engine in F steps per tick, as the window
+// does. Fails when two aircraft on their way came closer than the separation;
+// the least distance between any two slots is reported too, parked aircraft
+// and the helper on its own lane stand closer than that by the layout.
+int check_separation(int argc, char* argv[]);
+
+// Renders `--export DIR|- [options]` offscreen into PNG files or a raw RGBA
+// stream. Fails on bad options or when the output can not be written.
+int export_frames(int argc, char* argv[]);
+
+// Runs `--save-checkpoint FILE TICKS [--planes P] [--seed S]` ticks of a new
+// engine and saves its state, for a warm start of the window or the export.
+int save_checkpoint(int argc, char* argv[]);
+
+// Runs `--benchmark-network AIRPORTS TICKS [--planes P] [--seed S]` ticks of a
+// network of aerodromes and prints the throughput.
+int benchmark_network(int argc, char* argv[]);
+
+// Runs `--differential TICKS [--planes P] [--seed S] [--plane-change N]` ticks
+// of aerodrome_engine next to the frozen reference_engine, changing the plane
+// number every N ticks. Fails with the first divergence and its state diff.
+int check_differential(int argc, char* argv[]);
+
+// Runs `--check-checkpoints TICKS [--planes P] [--seed S] [--plane-change N]
+// [--interval I]` ticks of an engine, saving and restoring it every I ticks and
+// ticking the restored copy next to it. Fails when a state is rejected or the
+// copy diverges, with the state diff.
+int check_checkpoints(int argc, char* argv[]);
+
+} // namespace headless
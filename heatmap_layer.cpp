@@ -0,0 +1,81 @@
+#include "heatmap_layer.h"
+
+#include "aerodrome_engine.h"
+
+#include <QColor>
+#include <QPainter>
+#include <QPen>
+#include <QRadialGradient>
+#include <QString>
+
+
+heatmap_layer::heatmap_layer()
+    : layer(static_cast<int>(aerodrome_engine::maximum_w) / SCALE_DOWN,
+            static_cast<int>(aerodrome_engine::maximum_h) / SCALE_DOWN,
+            QImage::Format_ARGB32_Premultiplied),
+      taxiway_anchor(aerodrome_engine::TAXIWAY_COUNT)
+{
+    layer.fill(Qt::transparent);
+
+    vector<size_t> endpoints(aerodrome_engine::TAXIWAY_COUNT, 0);
+    for (auto& [point_id, endpoint] : aerodrome_engine::TAXIWAY_ENDPOINTS) {
+        auto [way, type] = endpoint;
+        if (point_id == aerodrome_engine::FAKE_POINT || type == detail::taxiway_endpoints_t::IGNORE) {
+            continue;
+        }
+        const point_t& position = aerodrome_engine::POINT_BY_ID[point_id];
+        taxiway_anchor[way] += QPointF(position.first, position.second) / SCALE_DOWN;
+        ++endpoints[way];
+    }
+    for (size_t way = 0; way != taxiway_anchor.size(); ++way) {
+        if (endpoints[way] != 0) {
+            taxiway_anchor[way] /= static_cast<qreal>(endpoints[way]);
+        }
+    }
+}
+
+
+void heatmap_layer::rebuild(const occupancy_map& occupancy) {
+    layer.fill(Qt::transparent);
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+
+    const qreal radius = 24.0 / SCALE_DOWN;
+    for (size_t point_id = 0; point_id != aerodrome_engine::POINT_BY_ID.size(); ++point_id) {
+        size_t level = occupancy.dwell_level(point_id);
+        if (level == 0) {
+            continue;
+        }
+        // yellow for a short stay, red for the busiest points
+        qreal heat = static_cast<qreal>(level) / (occupancy_map::LEVELS - 1);
+        QColor color = QColor::fromHsvF((1 - heat) / 6, 1, 1, 0.25 + 0.5 * heat);
+
+        const point_t& position = aerodrome_engine::POINT_BY_ID[point_id];
+        QPointF center(position.first / SCALE_DOWN, position.second / SCALE_DOWN);
+        QRadialGradient glow(center, radius);
+        glow.setColorAt(0, color);
+        color.setAlpha(0);
+        glow.setColorAt(1, color);
+        painter.setBrush(glow);
+        painter.drawEllipse(center, radius, radius);
+    }
+
+    painter.setBrush(Qt::NoBrush);
+    for (size_t way = 0; way != taxiway_anchor.size(); ++way) {
+        size_t level = occupancy.hold_level(way);
+        if (level == 0 || taxiway_anchor[way].isNull()) {
+            continue;
+        }
+        qreal hold = static_cast<qreal>(level) / (occupancy_map::LEVELS - 1);
+        QColor color = QColor::fromHsvF((1 - hold) / 6, 1, 1);
+        painter.setPen(QPen(color, 1 + 3 * hold));
+        painter.drawEllipse(taxiway_anchor[way], radius, radius);
+        painter.drawText(taxiway_anchor[way] + QPointF(radius + 2, 4),
+                         QString::number(occupancy.mean_depth(way), 'f', 1));
+    }
+}
+
+const QImage& heatmap_layer::image() const {
+    return layer;
+}
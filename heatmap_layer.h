@@ -0,0 +1,29 @@
+#pragma once
+
+#include "occupancy_map.h"
+
+#include <QImage>
+#include <QPointF>
+#include <vector>
+
+using std::vector;
+
+
+// Congestion overlay drawn from an occupancy_map: a glow over every point as
+// warm as its dwell, and a ring with the mean queue depth on every taxiway that
+// was held. The layer covers the whole aerodrome at a reduced resolution and is
+// only redrawn by rebuild, which callers do when the map reports a change.
+class heatmap_layer {
+public:
+    heatmap_layer();
+
+    void rebuild(const occupancy_map& occupancy);
+    const QImage& image() const;
+
+private:
+    constexpr static int SCALE_DOWN = 2;
+
+    QImage layer;
+    // middle of the endpoints of every taxiway
+    vector<QPointF> taxiway_anchor;
+};
@@ -0,0 +1,303 @@
+#include "kinematic_model.h"
+
+#include "aircraft_slots.h"
+#include "simd_lanes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace {
+
+// position of a missing leader, its circle lies beyond the end of any edge
+constexpr float NO_LEADER = 1e6f;
+
+} // namespace
+
+
+kinematic_model::kinematic_model(size_t slots) {
+    resize(slots);
+}
+
+void kinematic_model::resize(size_t new_slots) {
+    slots = new_slots;
+    padded = detail::round_up(new_slots, LANE);
+
+    from_point.resize(padded, NO_POINT);
+    to_point.resize(padded, NO_POINT);
+    origin_x.resize(padded, 0);
+    origin_y.resize(padded, 0);
+    direction_x.resize(padded, 0);
+    direction_y.resize(padded, 0);
+    length.resize(padded, 0);
+    distance.resize(padded, 0);
+    velocity.resize(padded, 0);
+    limit.resize(padded, 0);
+    leader_x.resize(padded, NO_LEADER);
+    leader_y.resize(padded, NO_LEADER);
+    leader.resize(padded, -1);
+    edges_dirty = true;
+}
+
+size_t kinematic_model::size() const {
+    return slots;
+}
+
+void kinematic_model::set_limits(float speed, float acceleration, float gap) {
+    max_speed = speed;
+    max_acceleration = acceleration;
+    separation = gap;
+}
+
+float kinematic_model::separation_distance() const {
+    return separation;
+}
+
+
+void kinematic_model::place(size_t slot, size_t point_id, float x, float y) {
+    from_point[slot] = point_id;
+    to_point[slot] = point_id;
+    origin_x[slot] = x;
+    origin_y[slot] = y;
+    direction_x[slot] = 0;
+    direction_y[slot] = 0;
+    length[slot] = 0;
+    distance[slot] = 0;
+    velocity[slot] = 0;
+    edges_dirty = true;
+}
+
+void kinematic_model::set_target(size_t slot, size_t point_id, float x, float y) {
+    if (!active(slot)) {
+        place(slot, point_id, x, y);
+        return;
+    }
+    if (to_point[slot] == point_id) {
+        return;
+    }
+
+    // the new edge starts wherever the aircraft is now, so an aircraft that has
+    // not reached its previous target yet continues without jumping
+    float start_x = this->x(slot);
+    float start_y = this->y(slot);
+    float dx = x - start_x;
+    float dy = y - start_y;
+    float edge_length = std::sqrt(dx * dx + dy * dy);
+
+    from_point[slot] = to_point[slot];
+    to_point[slot] = point_id;
+    origin_x[slot] = start_x;
+    origin_y[slot] = start_y;
+    direction_x[slot] = edge_length > 0 ? dx / edge_length : 0;
+    direction_y[slot] = edge_length > 0 ? dy / edge_length : 0;
+    length[slot] = edge_length;
+    distance[slot] = 0;
+    edges_dirty = true;
+}
+
+void kinematic_model::remove(size_t slot) {
+    from_point[slot] = NO_POINT;
+    to_point[slot] = NO_POINT;
+    length[slot] = 0;
+    distance[slot] = 0;
+    velocity[slot] = 0;
+    edges_dirty = true;
+}
+
+void kinematic_model::clear() {
+    for (size_t slot = 0; slot != slots; ++slot) {
+        remove(slot);
+    }
+}
+
+void kinematic_model::follow(const aircraft_slots& aircraft) {
+    for (size_t slot = 0; slot != aircraft.size(); ++slot) {
+        if (!aircraft.visible(slot)) {
+            if (active(slot)) {
+                remove(slot);
+            }
+            continue;
+        }
+        size_t point_id = aircraft.current(slot);
+        const point_t& point = aerodrome_engine::POINT_BY_ID[point_id];
+        if (active(slot)) {
+            set_target(slot, point_id, static_cast<float>(point.first), static_cast<float>(point.second));
+        } else {
+            place(slot, point_id, static_cast<float>(point.first), static_cast<float>(point.second));
+        }
+    }
+}
+
+
+void kinematic_model::step(float dt) {
+    if (edges_dirty) {
+        order_edges();
+    }
+    separation_kernel();
+    integration_kernel(dt);
+}
+
+
+bool kinematic_model::active(size_t slot) const {
+    return to_point[slot] != NO_POINT;
+}
+
+float kinematic_model::x(size_t slot) const {
+    return origin_x[slot] + direction_x[slot] * distance[slot];
+}
+
+float kinematic_model::y(size_t slot) const {
+    return origin_y[slot] + direction_y[slot] * distance[slot];
+}
+
+bool kinematic_model::arrived(size_t slot) const {
+    return distance[slot] >= length[slot];
+}
+
+
+// Aircraft heading for the same point are ordered by the distance left to it;
+// each one follows the nearest aircraft ahead of it, and the first one follows
+// the aircraft that left the point last. The order can only change when an edge
+// is assigned, because followers never overtake.
+void kinematic_model::order_edges() {
+    vector<size_t> order(slots);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        if (to_point[lhs] != to_point[rhs]) {
+            return to_point[lhs] < to_point[rhs];
+        }
+        float left = length[lhs] - distance[lhs];
+        float right = length[rhs] - distance[rhs];
+        return left != right ? left < right : lhs < rhs;
+    });
+
+    // moving aircraft by the point they left, nearest to it first
+    vector<size_t> departed;
+    for (size_t slot = 0; slot != slots; ++slot) {
+        if (active(slot) && from_point[slot] != to_point[slot]) {
+            departed.push_back(slot);
+        }
+    }
+    std::sort(departed.begin(), departed.end(), [&](size_t lhs, size_t rhs) {
+        if (from_point[lhs] != from_point[rhs]) {
+            return from_point[lhs] < from_point[rhs];
+        }
+        return distance[lhs] < distance[rhs];
+    });
+
+    std::fill(leader.begin(), leader.end(), -1);
+    for (size_t k = 0; k != order.size(); ++k) {
+        size_t current = order[k];
+        if (!active(current) || from_point[current] == to_point[current]) {
+            continue;
+        }
+        if (k != 0 && to_point[order[k - 1]] == to_point[current]) {
+            leader[current] = static_cast<std::int32_t>(order[k - 1]);
+            continue;
+        }
+        auto last = std::lower_bound(departed.begin(), departed.end(), to_point[current], [&](size_t slot, size_t point_id) {
+            return from_point[slot] < point_id;
+        });
+        if (last != departed.end() && from_point[*last] == to_point[current]) {
+            leader[current] = static_cast<std::int32_t>(*last);
+        }
+    }
+    edges_dirty = false;
+}
+
+
+// A leader heading for the same point stands in on the follower's own edge at
+// its distance from the point, one that left the point at its position. The
+// edge enters the circle of radius `separation` around it at
+//   entry = p - sqrt(separation^2 - (|r|^2 - p^2)),  r = leader - origin, p = r . direction
+// limit[i] = min(length[i], entry) unless the edge misses the circle or has left it
+void kinematic_model::separation_kernel() {
+    for (size_t i = 0; i != padded; ++i) {
+        std::int32_t j = leader[i];
+        if (j < 0) {
+            leader_x[i] = NO_LEADER;
+            leader_y[i] = NO_LEADER;
+        } else if (to_point[static_cast<size_t>(j)] == to_point[i]) {
+            float along = length[i] - (length[j] - distance[j]);
+            leader_x[i] = origin_x[i] + direction_x[i] * along;
+            leader_y[i] = origin_y[i] + direction_y[i] * along;
+        } else {
+            leader_x[i] = x(static_cast<size_t>(j));
+            leader_y[i] = y(static_cast<size_t>(j));
+        }
+    }
+
+    const float* len = length.data();
+    const float* s = distance.data();
+    float* lim = limit.data();
+    const float gap = separation * separation;
+    size_t i = 0;
+
+#ifdef AERODROME_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 gap_2 = _mm_set1_ps(gap);
+    for (; i + LANE <= padded; i += LANE) {
+        __m128 rx = _mm_sub_ps(_mm_loadu_ps(leader_x.data() + i), _mm_loadu_ps(origin_x.data() + i));
+        __m128 ry = _mm_sub_ps(_mm_loadu_ps(leader_y.data() + i), _mm_loadu_ps(origin_y.data() + i));
+        __m128 p = _mm_add_ps(_mm_mul_ps(rx, _mm_loadu_ps(direction_x.data() + i)),
+                              _mm_mul_ps(ry, _mm_loadu_ps(direction_y.data() + i)));
+        __m128 off = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(p, p));
+        __m128 reach = _mm_sub_ps(gap_2, off);
+        __m128 root = _mm_sqrt_ps(_mm_max_ps(reach, zero));
+        __m128 l = _mm_loadu_ps(len + i);
+
+        __m128 bounded = _mm_and_ps(_mm_cmpgt_ps(reach, zero),
+                                    _mm_cmpgt_ps(_mm_add_ps(p, root), _mm_loadu_ps(s + i)));
+        __m128 entry = _mm_min_ps(l, _mm_sub_ps(p, root));
+        _mm_storeu_ps(lim + i, _mm_or_ps(_mm_and_ps(bounded, entry), _mm_andnot_ps(bounded, l)));
+    }
+#endif
+    for (; i != padded; ++i) {
+        float rx = leader_x[i] - origin_x[i];
+        float ry = leader_y[i] - origin_y[i];
+        float p = rx * direction_x[i] + ry * direction_y[i];
+        float reach = gap - (rx * rx + ry * ry - p * p);
+        float root = std::sqrt(std::max(reach, 0.0f));
+        lim[i] = reach > 0 && p + root > s[i] ? std::min(len[i], p - root) : len[i];
+    }
+}
+
+
+// Accelerates towards the speed limit while still being able to stop at limit[i]:
+//   v' = min(v + a * dt, v_max, sqrt(2 * a * (limit - s)))
+//   s' = max(s, min(s + v' * dt, limit))
+void kinematic_model::integration_kernel(float dt) {
+    float* s = distance.data();
+    float* v = velocity.data();
+    const float* lim = limit.data();
+    const float a = max_acceleration;
+    size_t i = 0;
+
+#ifdef AERODROME_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 step = _mm_set1_ps(dt);
+    const __m128 boost = _mm_set1_ps(a * dt);
+    const __m128 brake = _mm_set1_ps(2 * a);
+    const __m128 top = _mm_set1_ps(max_speed);
+    for (; i + LANE <= padded; i += LANE) {
+        __m128 si = _mm_loadu_ps(s + i);
+        __m128 vi = _mm_loadu_ps(v + i);
+        __m128 li = _mm_loadu_ps(lim + i);
+
+        __m128 remaining = _mm_max_ps(_mm_sub_ps(li, si), zero);
+        __m128 stopping = _mm_sqrt_ps(_mm_mul_ps(brake, remaining));
+        __m128 vn = _mm_min_ps(_mm_min_ps(_mm_add_ps(vi, boost), top), stopping);
+        __m128 sn = _mm_max_ps(si, _mm_min_ps(_mm_add_ps(si, _mm_mul_ps(vn, step)), li));
+
+        _mm_storeu_ps(v + i, vn);
+        _mm_storeu_ps(s + i, sn);
+    }
+#endif
+    for (; i != padded; ++i) {
+        float remaining = std::max(lim[i] - s[i], 0.0f);
+        float vn = std::min({v[i] + a * dt, max_speed, std::sqrt(2 * a * remaining)});
+        v[i] = vn;
+        s[i] = std::max(s[i], std::min(s[i] + vn * dt, lim[i]));
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+class aircraft_slots;
+
+
+// Continuous movement of aircraft along the edges of the aerodrome graph.
+// Every slot holds one aircraft moving from an edge origin towards a target point
+// with bounded acceleration; an aircraft heading for a point keeps at least
+// `separation` from the one ahead of it on the way there, which is either
+// heading for the same point or has just left it. Aircraft whose ways only
+// pass near each other are not separated. All per-slot data is stored as
+// struct-of-arrays padded to the SIMD width, so the kernels in step() run over
+// whole lanes.
+class kinematic_model {
+public:
+    constexpr static size_t LANE = 4;
+    constexpr static size_t NO_POINT = static_cast<size_t>(-1);
+
+    explicit kinematic_model(size_t slots = 0);
+
+    void resize(size_t slots);
+    size_t size() const;
+
+    void set_limits(float max_speed, float max_acceleration, float separation);
+    float separation_distance() const;
+
+    // places the slot at `point` with zero speed
+    void place(size_t slot, size_t point_id, float x, float y);
+    // starts moving the slot from its current position towards `point`
+    void set_target(size_t slot, size_t point_id, float x, float y);
+    void remove(size_t slot);
+    void clear();
+    // targets every visible slot at its current point, as placed after a tick
+    void follow(const aircraft_slots& aircraft);
+
+    void step(float dt);
+
+    bool active(size_t slot) const;
+    float x(size_t slot) const;
+    float y(size_t slot) const;
+    // at the target, or placed and not moving yet
+    bool arrived(size_t slot) const;
+
+private:
+    void order_edges();
+    void separation_kernel();
+    void integration_kernel(float dt);
+
+private:
+    size_t slots{0};
+    size_t padded{0};
+    bool edges_dirty{false};
+    float max_speed{90};
+    float max_acceleration{400};
+    float separation{21};
+
+    // per-slot edge description
+    vector<size_t> from_point;
+    vector<size_t> to_point;
+    vector<float> origin_x;
+    vector<float> origin_y;
+    vector<float> direction_x;
+    vector<float> direction_y;
+    vector<float> length;
+
+    // per-slot motion state
+    vector<float> distance;
+    vector<float> velocity;
+    vector<float> limit;
+    vector<float> leader_x;
+    vector<float> leader_y;
+
+    // slot of the nearest aircraft ahead on the way to the target, -1 if none
+    vector<std::int32_t> leader;
+};
@@ -1,14 +1,67 @@
 #include "main_window.h"
+#include "headless.h"
 
 #include <QApplication>
 #include <QGuiApplication>
 #include <QScreen>
+#include <cstddef>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <string>
+
+namespace {
+
+// every aerodrome of a network gets a tile and a thread
+constexpr std::size_t MAX_NETWORK_AIRPORTS = 64;
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
+    if (argc >= 2 && std::strcmp(argv[1], "--check-allocations") == 0) {
+        return headless::check_allocations(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--check-separation") == 0) {
+        return headless::check_separation(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--export") == 0) {
+        return headless::export_frames(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--save-checkpoint") == 0) {
+        return headless::save_checkpoint(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--benchmark-network") == 0) {
+        return headless::benchmark_network(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--differential") == 0) {
+        return headless::check_differential(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--check-checkpoints") == 0) {
+        return headless::check_checkpoints(argc, argv);
+    }
+
+    std::size_t airports = 0;
+    if (argc == 3 && std::strcmp(argv[1], "--network") == 0) {
+        try {
+            airports = std::stoul(argv[2]);
+        } catch (const std::exception&) {
+            airports = 0;
+        }
+        if (airports == 0 || airports > MAX_NETWORK_AIRPORTS) {
+            std::cerr << "usage: --network AIRPORTS, from 1 to " << MAX_NETWORK_AIRPORTS << std::endl;
+            return 2;
+        }
+    }
+
     QApplication a(argc, argv);
     main_window w;
+    if (argc == 3 && std::strcmp(argv[1], "--checkpoint") == 0) {
+        w.open_checkpoint(argv[2]);
+    }
+    if (airports != 0) {
+        w.open_network(airports);
+    }
     w.show();
     return a.exec();
 }
@@ -1,7 +1,15 @@
 #include "main_window.h"
 #include "./ui_main_window.h"
 
+#include <cmath>
 #include <iostream>
+#include <QFileDialog>
+#include <QGridLayout>
+#include <QLabel>
+#include <QMenu>
+#include <QMenuBar>
+#include <QString>
+#include <QVBoxLayout>
 
 main_window::main_window(QWidget *parent)
     : QMainWindow(parent)
@@ -9,9 +17,13 @@ main_window::main_window(QWidget *parent)
 {
     ui->setupUi(this);
     ui->widget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    ui->horizontalSlider->setMaximum(static_cast<int>(aerodrome_engine::MAX_PLANE_NUMBER));
     ui->widget->set_label(ui->background_label);
-    QObject::connect(ui->horizontalSlider, SIGNAL(sliderMoved(int)), ui->widget, SLOT(set_plane_number(int)));
-    QObject::connect(ui->horizontalSlider_2, SIGNAL(sliderMoved(int)), ui->widget, SLOT(set_speed(int)));
+    connect_tile(ui->widget);
+
+    state_menu = ui->menubar->addMenu("State");
+    state_menu->addAction("Save checkpoint...", this, SLOT(save_checkpoint()));
+    state_menu->addAction("Load checkpoint...", this, SLOT(load_checkpoint()));
 }
 
 main_window::~main_window() {
@@ -19,3 +31,107 @@ main_window::~main_window() {
 }
 
 
+void main_window::open_checkpoint(const QString& path) {
+    if (network) {
+        ui->statusbar->showMessage("Checkpoints are not available for a network");
+        return;
+    }
+    if (!ui->widget->load_checkpoint(path)) {
+        ui->statusbar->showMessage(QString("Can not load checkpoint %1").arg(path));
+        return;
+    }
+    ui->horizontalSlider->setValue(ui->widget->plane_number());
+    ui->statusbar->showMessage(QString("Loaded checkpoint %1").arg(path));
+}
+
+
+void main_window::save_checkpoint() {
+    QString path = QFileDialog::getSaveFileName(this, "Save checkpoint", QString(), "Checkpoints (*.ardm)");
+    if (path.isEmpty()) {
+        return;
+    }
+    ui->statusbar->showMessage(ui->widget->save_checkpoint(path)
+            ? QString("Saved checkpoint %1").arg(path)
+            : QString("Can not save checkpoint %1").arg(path));
+}
+
+void main_window::load_checkpoint() {
+    QString path = QFileDialog::getOpenFileName(this, "Load checkpoint", QString(), "Checkpoints (*.ardm)");
+    if (!path.isEmpty()) {
+        open_checkpoint(path);
+    }
+}
+
+
+// The designed widget shows the first aerodrome, every other one gets a tile of
+// its own. The network is ticked here and the tiles only follow it.
+void main_window::open_network(std::size_t airports) {
+    network = std::make_unique<aerodrome_network>(airports, aerodrome_network::DEFAULT_FLEET);
+    network->set_plane_number(static_cast<std::size_t>(ui->horizontalSlider->value()));
+    // loading into a networked engine would overwrite the flights it owes the network
+    state_menu->menuAction()->setEnabled(false);
+
+    auto* grid = new QGridLayout();
+    ui->horizontalLayout_3->removeWidget(ui->widget);
+    ui->horizontalLayout_3->insertLayout(0, grid, 1);
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(airports))));
+    for (std::size_t id = 0; id != airports; ++id) {
+        radar_emulator_widget* tile = id == 0 ? ui->widget : make_tile();
+        tile->show_external(network->airport(id));
+        grid->addWidget(tile, static_cast<int>(id) / columns, static_cast<int>(id) % columns);
+        tiles.push_back(tile);
+    }
+
+    aerodrome_box = new QComboBox(ui->widget_2);
+    aerodrome_box->addItem("All aerodromes");
+    for (std::size_t id = 0; id != airports; ++id) {
+        aerodrome_box->addItem(QString("Aerodrome %1").arg(id + 1));
+    }
+    ui->verticalLayout_2->insertWidget(0, aerodrome_box);
+    QObject::connect(aerodrome_box, SIGNAL(currentIndexChanged(int)), this, SLOT(select_aerodrome(int)));
+
+    network_timer = new QTimer(this);
+    QObject::connect(network_timer, SIGNAL(timeout()), this, SLOT(update_network()));
+    QObject::connect(ui->horizontalSlider_2, SIGNAL(sliderMoved(int)), this, SLOT(set_network_speed(int)));
+    network_timer->start(NETWORK_INTERVAL);
+}
+
+
+void main_window::update_network() {
+    network->update_network();
+    for (radar_emulator_widget* tile : tiles) {
+        tile->aerodrome_updated();
+    }
+}
+
+void main_window::set_network_speed(int boost) {
+    network_timer->setInterval(NETWORK_INTERVAL / boost);
+}
+
+void main_window::select_aerodrome(int index) {
+    for (std::size_t id = 0; id != tiles.size(); ++id) {
+        tiles[id]->setVisible(index == 0 || static_cast<std::size_t>(index) == id + 1);
+    }
+}
+
+
+// Same structure as the designed widget: the radar paints into a label covering it.
+radar_emulator_widget* main_window::make_tile() {
+    auto* tile = new radar_emulator_widget(ui->widget->satellite(), ui->centralwidget);
+    auto* layout = new QVBoxLayout(tile);
+    auto* label = new QLabel(tile);
+    layout->addWidget(label);
+    tile->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    tile->set_label(label);
+    connect_tile(tile);
+    return tile;
+}
+
+void main_window::connect_tile(radar_emulator_widget* tile) {
+    QObject::connect(ui->horizontalSlider, SIGNAL(sliderMoved(int)), tile, SLOT(set_plane_number(int)));
+    QObject::connect(ui->horizontalSlider_2, SIGNAL(sliderMoved(int)), tile, SLOT(set_speed(int)));
+    QObject::connect(ui->vehicles_slider, SIGNAL(sliderMoved(int)), tile, SLOT(set_vehicle_number(int)));
+    QObject::connect(ui->continuous_checkbox, SIGNAL(toggled(bool)), tile, SLOT(set_continuous_motion(bool)));
+    QObject::connect(ui->heatmap_checkbox, SIGNAL(toggled(bool)), tile, SLOT(set_heatmap(bool)));
+    QObject::connect(tile, SIGNAL(aircraft_selected(QString)), ui->statusbar, SLOT(showMessage(QString)));
+}
@@ -1,6 +1,17 @@
 #pragma once
 
+#include "aerodrome_network.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <QComboBox>
 #include <QMainWindow>
+#include <QMenu>
+#include <QString>
+#include <QTimer>
+
+class radar_emulator_widget;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class main_window; }
@@ -14,6 +25,29 @@ public:
     main_window(QWidget *parent = nullptr);
     ~main_window();
 
+    void open_checkpoint(const QString& path);
+    // Replaces the single aerodrome with a network of `airports` tiled ones.
+    // Checkpoints hold one aerodrome, so they are not available from then on.
+    void open_network(std::size_t airports);
+
+private Q_SLOTS:
+    void save_checkpoint();
+    void load_checkpoint();
+    void update_network();
+    void set_network_speed(int boost);
+    void select_aerodrome(int index);
+
+private:
+    radar_emulator_widget* make_tile();
+    void connect_tile(radar_emulator_widget* tile);
+
 private:
     Ui::main_window *ui;
+    QMenu* state_menu{nullptr};
+    std::unique_ptr<aerodrome_network> network;
+    QTimer* network_timer{nullptr};
+    QComboBox* aerodrome_box{nullptr};
+    std::vector<radar_emulator_widget*> tiles;
+
+    constexpr static int NETWORK_INTERVAL = 1'000;
 };
@@ -0,0 +1,128 @@
+#include "occupancy_map.h"
+
+#include <algorithm>
+
+
+occupancy_map::occupancy_map()
+    : slots(2 * aerodrome_engine::SPAWNPOINT.size()),
+      window_points(WINDOW_TICKS * slots, 0),
+      window_counts(WINDOW_TICKS, 0),
+      window_depths(WINDOW_TICKS * aerodrome_engine::TAXIWAY_COUNT, 0),
+      point_dwell(aerodrome_engine::POINT_BY_ID.size(), 0),
+      way_hold(aerodrome_engine::TAXIWAY_COUNT, 0),
+      way_depth(aerodrome_engine::TAXIWAY_COUNT, 0),
+      point_level(aerodrome_engine::POINT_BY_ID.size(), 0),
+      way_level(aerodrome_engine::TAXIWAY_COUNT, 0),
+      depth_level(aerodrome_engine::TAXIWAY_COUNT, 0)
+{}
+
+
+bool occupancy_map::record(const aerodrome_engine& engine) {
+    std::uint16_t* points = &window_points[next * slots];
+    std::uint16_t* depths = &window_depths[next * aerodrome_engine::TAXIWAY_COUNT];
+
+    // the oldest tick leaves the window
+    if (filled == WINDOW_TICKS) {
+        for (size_t i = 0; i != window_counts[next]; ++i) {
+            --point_dwell[points[i]];
+        }
+        for (size_t way = 0; way != aerodrome_engine::TAXIWAY_COUNT; ++way) {
+            way_hold[way] -= depths[way] != 0 ? 1 : 0;
+            way_depth[way] -= depths[way];
+        }
+    } else {
+        ++filled;
+    }
+
+    size_t count = 0;
+    auto occupy = [&](size_t point_id) -> void {
+        // aircraft in the air or beyond the runway are not on the aerodrome
+        if (point_id != aerodrome_engine::FAKE_POINT && count != slots) {
+            points[count++] = static_cast<std::uint16_t>(point_id);
+            ++point_dwell[point_id];
+        }
+    };
+    for (auto& [id, point_id] : engine.departures()) {
+        occupy(point_id);
+    }
+    for (auto& [id, steps] : engine.arrivals()) {
+        occupy(steps.front());
+    }
+    window_counts[next] = static_cast<std::uint16_t>(count);
+
+    for (size_t way = 0; way != aerodrome_engine::TAXIWAY_COUNT; ++way) {
+        size_t depth = engine.taxiway_queues()[way].size();
+        depths[way] = static_cast<std::uint16_t>(depth);
+        way_hold[way] += depth != 0 ? 1 : 0;
+        way_depth[way] += static_cast<std::uint32_t>(depth);
+    }
+
+    next = (next + 1) % WINDOW_TICKS;
+    return update_levels();
+}
+
+
+void occupancy_map::clear() {
+    next = 0;
+    filled = 0;
+    max_dwell = 0;
+    std::fill(window_counts.begin(), window_counts.end(), 0);
+    std::fill(point_dwell.begin(), point_dwell.end(), 0);
+    std::fill(way_hold.begin(), way_hold.end(), 0);
+    std::fill(way_depth.begin(), way_depth.end(), 0);
+    std::fill(point_level.begin(), point_level.end(), 0);
+    std::fill(way_level.begin(), way_level.end(), 0);
+    std::fill(depth_level.begin(), depth_level.end(), 0);
+}
+
+
+size_t occupancy_map::ticks() const {
+    return filled;
+}
+
+double occupancy_map::dwell(size_t point_id) const {
+    return max_dwell == 0 ? 0 : static_cast<double>(point_dwell[point_id]) / max_dwell;
+}
+
+double occupancy_map::hold(size_t way) const {
+    return filled == 0 ? 0 : static_cast<double>(way_hold[way]) / filled;
+}
+
+double occupancy_map::mean_depth(size_t way) const {
+    return filled == 0 ? 0 : static_cast<double>(way_depth[way]) / filled;
+}
+
+size_t occupancy_map::dwell_level(size_t point_id) const {
+    return point_level[point_id];
+}
+
+size_t occupancy_map::hold_level(size_t way) const {
+    return way_level[way];
+}
+
+
+// The busiest point sets the dwell scale, it is looked up here once per tick
+// rather than kept while points leave the window.
+bool occupancy_map::update_levels() {
+    max_dwell = *std::max_element(point_dwell.begin(), point_dwell.end());
+
+    // a value has to leave the band of its level by HYSTERESIS to move it,
+    // so values on a border do not flip the level every tick
+    auto settle = [](std::uint8_t& level, double value, size_t top) -> bool {
+        if (value >= level - HYSTERESIS && value < level + 1 + HYSTERESIS) {
+            return false;
+        }
+        level = static_cast<std::uint8_t>(std::min(top, static_cast<size_t>(std::max(0.0, value))));
+        return true;
+    };
+
+    bool changed = false;
+    for (size_t point_id = 0; point_id != point_level.size(); ++point_id) {
+        changed |= settle(point_level[point_id], dwell(point_id) * LEVELS, LEVELS - 1);
+    }
+    for (size_t way = 0; way != way_level.size(); ++way) {
+        changed |= settle(way_level[way], hold(way) * LEVELS, LEVELS - 1);
+        changed |= settle(depth_level[way], 2 * mean_depth(way), 255);
+    }
+    return changed;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Where aircraft spend their time over the last WINDOW_TICKS ticks: dwell per
+// point, hold time and queue depth per taxiway. Every tick adds its occupied
+// points and queue depths to fixed counters and takes back the tick leaving
+// the window, kept in a ring, so history is never rescanned and a recording
+// tick allocates nothing. Values are also kept quantized to LEVELS levels to
+// tell a noticeable change from noise.
+class occupancy_map {
+public:
+    constexpr static size_t WINDOW_TICKS = 300;
+    constexpr static size_t LEVELS = 8;
+    // share of a level a value has to pass the border of its level by
+    constexpr static double HYSTERESIS = 0.25;
+
+    occupancy_map();
+
+    // records the state after a tick, true when any level changed
+    bool record(const aerodrome_engine& engine);
+    void clear();
+
+    // ticks in the window so far
+    size_t ticks() const;
+    // share of the busiest point's dwell, in [0, 1]
+    double dwell(size_t point_id) const;
+    // share of the window the taxiway was held
+    double hold(size_t way) const;
+    double mean_depth(size_t way) const;
+
+    size_t dwell_level(size_t point_id) const;
+    size_t hold_level(size_t way) const;
+
+private:
+    bool update_levels();
+
+private:
+    // aircraft a tick can hold
+    size_t slots;
+    size_t next{0};
+    size_t filled{0};
+
+    // the window ring: occupied points and queue depths of every tick
+    vector<std::uint16_t> window_points;
+    vector<std::uint16_t> window_counts;
+    vector<std::uint16_t> window_depths;
+
+    vector<std::uint32_t> point_dwell;
+    vector<std::uint32_t> way_hold;
+    vector<std::uint32_t> way_depth;
+    std::uint32_t max_dwell{0};
+
+    vector<std::uint8_t> point_level;
+    vector<std::uint8_t> way_level;
+    // mean depths in halves of an aircraft
+    vector<std::uint8_t> depth_level;
+};
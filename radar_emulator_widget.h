@@ -1,34 +1,28 @@
 #pragma once
 
+#include "aerodrome_engine.h"
+#include "aircraft_slots.h"
+#include "ground_fleet.h"
+#include "heatmap_layer.h"
+#include "kinematic_model.h"
+#include "occupancy_map.h"
+#include "radar_renderer.h"
+#include "spatial_grid.h"
+#include "tile_cache.h"
+#include "tile_pyramid.h"
+
 #include <cstddef>
-#include <deque>
-#include <map>
-#include <set>
+#include <memory>
 #include <vector>
+#include <QElapsedTimer>
 #include <QRectF>
 #include <QLabel>
+#include <QPixmap>
+#include <QString>
 #include <QTimer>
-#include <queue>
 #include <QWidget>
-#include <unordered_map>
 
-using std::pair;
-using std::map;
-using std::unordered_map;
 using std::vector;
-using std::set;
-using std::queue;
-using std::deque;
-using point_t = pair<qreal, qreal>;  // sorry about that
-
-
-namespace detail {
-
-enum class taxiway_endpoints_t {
-    START, END, IGNORE
-};
-
-} // namespace detail
 
 
 class radar_emulator_widget : public QWidget {
@@ -38,43 +32,106 @@ class radar_emulator_widget : public QWidget {
 
 public:
     radar_emulator_widget(QWidget* parent = nullptr);
+    // shows the satellite image of another widget instead of building one more
+    radar_emulator_widget(std::shared_ptr<const tile_pyramid> satellite, QWidget* parent = nullptr);
+    std::shared_ptr<const tile_pyramid> satellite() const;
     void paintEvent(QPaintEvent*) override;
+    void resizeEvent(QResizeEvent*) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
     void set_label(QLabel* label);
+    int plane_number() const;
+
+    // Shows an aerodrome ticked from outside instead of the own one, e.g. one of
+    // a network; aerodrome_updated() has to follow every tick of it.
+    void show_external(aerodrome_engine& source);
+    void aerodrome_updated();
+
+    bool save_checkpoint(const QString& path) const;
+    // restarts the view from the saved schedule, false if the file can not be used
+    bool load_checkpoint(const QString& path);
 
 public Q_SLOTS:
     void set_plane_number(int value);
     void set_speed(int boost);
+    void set_continuous_motion(bool enabled);
+    void set_vehicle_number(int value);
+    void set_heatmap(bool enabled);
+    void set_region_filter(const QRectF& region);
+    void clear_region_filter();
+
+Q_SIGNALS:
+    void aircraft_selected(const QString& description);
 
 private:
-    QRectF scaled_coordinates(qreal x, qreal y, qreal w, qreal h);
-    qreal scale(qreal coord, qreal max_src, qreal max_scaled);
+    void refresh_index();
+    void reset_slots();
+    void clamp_view();
+    // widget to label coordinates, and label to aerodrome ones
+    QPointF to_frame(const QPointF& position) const;
+    QPointF to_source(const QPointF& position) const;
+    size_t pick(const QPointF& position) const;
+    QString describe(size_t slot) const;
+    qreal tick_progress() const;
+    point_t aircraft_position(size_t slot) const;
 
 private Q_SLOTS:
     void update_aerodrome();
+    void advance_frame();
 
 private:
     QLabel* painting_label;
     QTimer* timer;
-    size_t plane_number{2};
-    size_t helper_position{0};
-    int helper_position_delta{0};
-    vector<pair<size_t, size_t>> departure_aircrafts;
-    vector<pair<size_t, deque<size_t>>> arrival_aircrafts;
-    unordered_map<size_t, vector<size_t>> arival_waiting_aircrafts;
-    vector<queue<size_t>> taxiway_que;
+    QTimer* frame_timer;
+    QElapsedTimer frame_clock;
+    QElapsedTimer tick_clock;
+    aircraft_slots aircraft;
+    kinematic_model kinematics;
+    ground_fleet fleet;
+    std::shared_ptr<const tile_pyramid> pyramid;
+    tile_cache tiles;
+    radar_renderer renderer;
+    vector<radar_renderer::mark_t> marks;
+    // kept up to date while hidden, so the overlay shows the whole window once enabled
+    occupancy_map occupancy;
+    heatmap_layer heatmap;
+    bool show_heatmap{false};
+    // visible part of the aerodrome in maximum_w x maximum_h coordinates
+    QRectF view{0, 0, maximum_w, maximum_h};
+    QPointF drag_position;
+    QPointF press_position;
+    bool dragging{false};
+    // region being selected with shift + drag and the applied filter, in
+    // maximum_w x maximum_h coordinates like the view itself
+    QRectF selection;
+    QRectF region;
+    bool selecting{false};
+    bool continuous_motion{false};
+    bool frame_settled{false};
+    spatial_grid index;
+    aerodrome_engine engine;
+    aerodrome_engine* shown{&engine};
 
 public:
-    constexpr static qreal maximum_w{static_cast<qreal>(1920)};
-    constexpr static qreal maximum_h{static_cast<qreal>(1080)};
-    constexpr static size_t point_pixel_size{21};
-    static vector<point_t> POINT_BY_ID;
+    constexpr static qreal maximum_w{static_cast<qreal>(aerodrome_engine::maximum_w)};
+    constexpr static qreal maximum_h{static_cast<qreal>(aerodrome_engine::maximum_h)};
+    constexpr static size_t point_pixel_size{radar_renderer::point_pixel_size};
 
 private:
     constexpr static int STANDART_SPEED = 1'000;
-    static vector<size_t> HELPER_TRAJECTORY;
-    static unordered_map<size_t, size_t> DEPARTURES_TRAJECTORY;
-    static unordered_map<size_t, vector<size_t>> DEPARTURES_VARIADIC_TRAJECTORY;
-    static vector<size_t> SPAWNPOINT;
-    static unordered_map<size_t, pair<size_t, detail::taxiway_endpoints_t>> TAXIWAY_ENDPOINTS;
+    constexpr static qreal FALLBACK_REFRESH_RATE = 60;
+    constexpr static qreal MAX_ZOOM = 16;
+    // zoom per wheel notch
+    constexpr static qreal ZOOM_STEP = 1.25;
+    constexpr static size_t TILE_CACHE_CAPACITY = 64;
+    constexpr static float INDEX_CELL_SIZE = 64;
+    // screen pixels a press may move and still count as a click
+    constexpr static qreal CLICK_DISTANCE = 4;
+    // kinematic limits are measured per scheduler tick, so they follow set_speed()
+    constexpr static float MAX_TAXI_SPEED = 90;
+    constexpr static float MAX_TAXI_ACCELERATION = 400;
 };
 
@@ -0,0 +1,151 @@
+#include "radar_renderer.h"
+
+#include <cmath>
+
+
+radar_renderer::radar_renderer(const tile_pyramid& pyramid)
+    : pyramid(pyramid)
+{}
+
+
+// The sprites are full-size canvases with the point in the top left corner,
+// only that corner is kept after scaling.
+void radar_renderer::resize(const QSize& size) {
+    int w = size.width();
+    int h = size.height();
+    int sprite_w = static_cast<int>(std::ceil(scale(point_pixel_size, aerodrome_engine::maximum_w, w))) + 1;
+    int sprite_h = static_cast<int>(std::ceil(scale(point_pixel_size, aerodrome_engine::maximum_h, h))) + 1;
+
+    auto sprite = [&](const QString& path) -> QImage {
+        return QImage(path).scaled(w, h).copy(0, 0, sprite_w, sprite_h);
+    };
+
+    frame_size = size;
+    green_point = sprite(":/src/img/point-sample.png");
+    blue_point = sprite(":/src/img/point-sample-blue.png");
+    yellow_point = sprite(":/src/img/yellow-point.png");
+}
+
+QSize radar_renderer::size() const {
+    return frame_size;
+}
+
+
+void radar_renderer::render(QPainter& painter, const QRectF& view, const vector<mark_t>& marks, tile_cache* tiles,
+                            const QImage* overlay) const {
+    draw_background(painter, view, tiles);
+    if (overlay) {
+        draw_overlay(painter, view, *overlay);
+    }
+    for (const mark_t& mark : marks) {
+        QRectF target = scaled_coordinates(view, mark.position.first, mark.position.second);
+        painter.drawImage(target.topLeft(), sprite_of(mark.kind));
+    }
+}
+
+
+void radar_renderer::outline(QPainter& painter, const QRectF& view, const QRectF& rect) const {
+    int w = frame_size.width();
+    int h = frame_size.height();
+    painter.setPen(QPen(Qt::white, 1, Qt::DashLine));
+    painter.drawRect(QRectF(QPointF(scale(rect.left() - view.left(), view.width(), w),
+                                    scale(rect.top() - view.top(), view.height(), h)),
+                            QPointF(scale(rect.right() - view.left(), view.width(), w),
+                                    scale(rect.bottom() - view.top(), view.height(), h))));
+}
+
+
+// Only the tiles intersecting the view are drawn, taken from the level closest
+// to the screen resolution, so every zoom costs about the same as the overview.
+// The image is stretched over the aerodrome whatever its size, so the view is
+// taken to image pixels to pick the tiles and the tiles back to place them.
+void radar_renderer::draw_background(QPainter& painter, const QRectF& view, tile_cache* tiles) const {
+    if (!pyramid.ready() || pyramid.source_size().isEmpty()) {
+        return;
+    }
+    int w = frame_size.width();
+    int h = frame_size.height();
+    qreal image_w = pyramid.source_size().width();
+    qreal image_h = pyramid.source_size().height();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    QRectF image_view(scale(view.left(), aerodrome_engine::maximum_w, image_w),
+                      scale(view.top(), aerodrome_engine::maximum_h, image_h),
+                      scale(view.width(), aerodrome_engine::maximum_w, image_w),
+                      scale(view.height(), aerodrome_engine::maximum_h, image_h));
+    size_t level = pyramid.level_for(image_view.width() / w);
+    QRect visible = pyramid.visible_tiles(level, image_view);
+
+    for (int row = visible.top(); row <= visible.bottom(); ++row) {
+        for (int column = visible.left(); column <= visible.right(); ++column) {
+            QRectF image_rect = pyramid.tile_source_rect(level, column, row);
+            QRectF source(QPointF(scale(image_rect.left(), image_w, aerodrome_engine::maximum_w),
+                                  scale(image_rect.top(), image_h, aerodrome_engine::maximum_h)),
+                          QPointF(scale(image_rect.right(), image_w, aerodrome_engine::maximum_w),
+                                  scale(image_rect.bottom(), image_h, aerodrome_engine::maximum_h)));
+            // rounding both corners keeps neighbouring tiles seamless
+            QPoint top_left(qRound(scale(source.left() - view.left(), view.width(), w)),
+                            qRound(scale(source.top() - view.top(), view.height(), h)));
+            QPoint bottom_right(qRound(scale(source.right() - view.left(), view.width(), w)),
+                                qRound(scale(source.bottom() - view.top(), view.height(), h)));
+            QRect target(top_left, bottom_right);
+
+            if (tiles) {
+                const QPixmap& tile = tiles->get(pyramid, level, column, row);
+                painter.drawPixmap(target, tile, tile.rect());
+            } else {
+                const QImage& tile = pyramid.tile(level, column, row);
+                painter.drawImage(target, tile, tile.rect());
+            }
+        }
+    }
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+}
+
+
+void radar_renderer::draw_overlay(QPainter& painter, const QRectF& view, const QImage& overlay) const {
+    QRectF source(scale(view.left(), aerodrome_engine::maximum_w, overlay.width()),
+                  scale(view.top(), aerodrome_engine::maximum_h, overlay.height()),
+                  scale(view.width(), aerodrome_engine::maximum_w, overlay.width()),
+                  scale(view.height(), aerodrome_engine::maximum_h, overlay.height()));
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(QRectF(QPointF(0, 0), QSizeF(frame_size)), overlay, source);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+}
+
+
+// Points keep their overview size on screen whatever the zoom is.
+QRectF radar_renderer::scaled_coordinates(const QRectF& view, qreal x, qreal y) const {
+    qreal w = frame_size.width();
+    qreal h = frame_size.height();
+    qreal half_point = static_cast<qreal>(point_pixel_size) / 2;
+    return QRectF(scale(x - view.left(), view.width(), w) - scale(half_point, aerodrome_engine::maximum_w, w),
+                  scale(y - view.top(), view.height(), h) - scale(half_point, aerodrome_engine::maximum_h, h),
+                  w,
+                  h);
+}
+
+qreal radar_renderer::scale(qreal coord, qreal max_src, qreal max_scaled) {
+    return coord / max_src * max_scaled;
+}
+
+
+radar_renderer::mark_kind_t radar_renderer::kind_of(const aircraft_slots& aircraft, size_t slot) {
+    if (slot == aircraft.helper()) {
+        return mark_kind_t::HELPER;
+    }
+    return aircraft.arrival(slot) ? mark_kind_t::ARRIVAL : mark_kind_t::DEPARTURE;
+}
+
+
+const QImage& radar_renderer::sprite_of(mark_kind_t kind) const {
+    switch (kind) {
+    case mark_kind_t::DEPARTURE:
+        return green_point;
+    case mark_kind_t::ARRIVAL:
+        return blue_point;
+    default:
+        return yellow_point;
+    }
+}
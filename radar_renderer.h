@@ -0,0 +1,61 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+#include "aircraft_slots.h"
+#include "tile_cache.h"
+#include "tile_pyramid.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+#include <QSize>
+#include <vector>
+
+using std::vector;
+
+
+// Painting of radar frames, shared by the widget and the offscreen export.
+// Everything is drawn from QImage, so frames may be rendered without a window
+// and from several threads at once; only the optional tile cache is GUI bound.
+class radar_renderer {
+public:
+    enum class mark_kind_t {
+        DEPARTURE, ARRIVAL, HELPER
+    };
+
+    struct mark_t {
+        mark_kind_t kind;
+        point_t position;
+    };
+
+    explicit radar_renderer(const tile_pyramid& pyramid);
+
+    // rescales the sprites for frames of `size`
+    void resize(const QSize& size);
+    QSize size() const;
+
+    // `view` is the visible part of the aerodrome in maximum_w x maximum_h coordinates,
+    // marks are drawn in the given order over the optional `overlay`, which covers the whole aerodrome
+    void render(QPainter& painter, const QRectF& view, const vector<mark_t>& marks, tile_cache* tiles = nullptr,
+                const QImage* overlay = nullptr) const;
+    void outline(QPainter& painter, const QRectF& view, const QRectF& rect) const;
+
+    QRectF scaled_coordinates(const QRectF& view, qreal x, qreal y) const;
+    static qreal scale(qreal coord, qreal max_src, qreal max_scaled);
+    static mark_kind_t kind_of(const aircraft_slots& aircraft, size_t slot);
+
+private:
+    void draw_background(QPainter& painter, const QRectF& view, tile_cache* tiles) const;
+    void draw_overlay(QPainter& painter, const QRectF& view, const QImage& overlay) const;
+    const QImage& sprite_of(mark_kind_t kind) const;
+
+public:
+    constexpr static size_t point_pixel_size{21};
+
+private:
+    const tile_pyramid& pyramid;
+    QSize frame_size;
+    QImage green_point;
+    QImage blue_point;
+    QImage yellow_point;
+};
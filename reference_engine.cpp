@@ -0,0 +1,570 @@
+#include "reference_engine.h"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_set>
+
+
+using std::unordered_set;
+using detail::taxiway_endpoints_t;
+
+
+// A copy of the topology and the sentinels rather than aerodrome_engine's
+// tables, so a change made to those shows up as a divergence.
+namespace {
+
+size_t FAIL_POINT = static_cast<size_t>(-2);
+size_t SKIP_POINT = static_cast<size_t>(-1);
+
+// the first of the fake points closing aerodrome_engine::POINT_BY_ID
+constexpr size_t FAKE_POINT = 175;
+constexpr size_t TAXIWAY_COUNT = 11;
+
+
+vector<size_t> HELPER_TRAJECTORY = {
+    FAKE_POINT, 160, 161, 162, 163, 164,
+    165, 166, 167, 168, 169, 170,
+    171, 172, 173, 174, FAKE_POINT
+};
+
+
+vector<size_t> SPAWNPOINT = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+    20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
+    30, 31, 32, 33, 34, 35, 36, 37, 38, 39
+};
+
+
+unordered_map<size_t, size_t> DEPARTURES_TRAJECTORY = {
+    { 0, 40 },
+    { 1, 41 },
+    { 42, 43 },
+    { 41, 42 },
+    { 40, 43 },
+    { 43, 44 },
+    { 44, 45 },
+    { 45, 46 },
+    { 47, 42 },
+    { 48, 47 },
+    { 49, 48 },
+    { 50, 48 },
+    { 51, 50 },
+    { 52, 51 },
+    { 53, 51 },
+    { 54, 53 },
+    { 55, 54 },
+    { 56, 55 },
+    { 8, 56 },
+    { 7, 55 },
+    { 6, 54 },
+    { 9, 53 },
+    { 10, 51 },
+    { 4, 52 },
+    { 11, 50 },
+    { 12, 48 },
+    { 2, 49 },
+    { 13, 47 },
+    { 14, 47 },
+    { 5, 51 },
+    { 3, 48 },
+    { 46, 57 },
+    { 20, 58 },
+    { 58, 59 },
+    { 19, 59 },
+    { 18, 59 },
+    { 59, 60 },
+    { 17, 60 },
+    { 60, 61 },
+    { 16, 61 },
+    { 15, 61 },
+    { 61, 62 },
+    { 62, 63 },
+    { 63, 64 },
+    { 64, 65 },
+    { 65, 66 },
+    { 66, 67 },
+    { 67, 68 },
+    { 68, 69 },
+    { 69, 70 },
+    { 28, 71 },
+    { 71, 72 },
+    { 27, 72 },
+    { 72, 73 },
+    { 26, 73 },
+    { 73, 74 },
+    { 25, 74 },
+    { 74, 75 },
+    { 24, 75 },
+    { 23, 75 },
+    { 75, 76 },
+    { 76, 77 },
+    { 22, 77 },
+    { 21, 78 },
+    { 77, 79 },
+    { 78, 79 },
+    { 79, 80 },
+    { 80, 81 },
+    { 81, 82 },
+    { 82, 83 },
+    { 83, 84 },
+    { 84, 85 },
+    { 85, 86 },
+    { 86, 87 },
+    { 87, 88 },
+    { 88, 66 },
+    { 39, 89 },
+    { 89, 90 },
+    { 38, 90 },
+    { 29, 90 },
+    { 90, 91 },
+    { 37, 91 },
+    { 30, 91 },
+    { 91, 92 },
+    { 31, 92 },
+    { 36, 92 },
+    { 92, 93 },
+    { 32, 93 },
+    { 35, 93 },
+    { 93, 94 },
+    { 33, 94 },
+    { 34, 94 },
+    { 94, 95 },
+    { 95, 96 },
+    { 96, 97 },
+    { 97, 98 },
+    { 99, 100 },
+    { 100, 101 },
+    { 101, 102 },
+    { 102, 103 },
+    { 103, 104 },
+    { 104, 105 },
+    { 105, 106 },
+    { 106, 107 },
+    { 107, 108 },
+    { 108, 82 },
+    { 109, 110 },
+    { 110, 111 },
+    { 111, 112 },
+    { 112, 113 },
+    { 113, 114 },
+    { 114, 115 },
+    { 115, 116 },
+    { 116, 117 },
+    { 117, 118 },
+    { 118, 119 },
+    { 119, 120 },
+    { 120, 121 },
+    { 121, 122 },
+    { 122, 123 },
+
+    /* departure from right */
+    { 123, 124 },
+    { 124, 125 },
+    { 125, 126 },
+    { 126, 127 },
+    { 127, 128 },
+    { 128, 129 },
+    { 129, 130 },
+    { 130, 131 },
+    { 131, 132 },
+    { 132, 133 },
+    { 133, 134 },
+    { 134, 135 },
+    { 135, 136 },
+    { 136, 137 },
+    { 137, 138 },
+    { 138, 139 },
+    { 139, FAKE_POINT },
+
+    /* departure from left */
+    { 57, 70 },
+    { 70, 140 },
+    { 140, 141 },
+    { 141, 142 },
+    { 142, 143 },
+    { 143, 144 },
+    { 144, 145 },
+    { 145, 146 },
+    { 146, 147 },
+    { 147, 148 },
+    { 148, 149 },
+    { 149, 150 },
+    { 150, 151 },
+    { 151, 152 },
+    { 152, 153 },
+    { 153, 154 },
+    { 154, 155 },
+    { 155, FAKE_POINT }
+
+
+
+};
+
+unordered_map<size_t, vector<size_t>> DEPARTURES_VARIADIC_TRAJECTORY = {
+    { 98, { 109, 99 } }
+};
+
+
+unordered_map<size_t, pair<size_t, taxiway_endpoints_t>> TAXIWAY_ENDPOINTS = {
+    { 0, {9, taxiway_endpoints_t::START} },
+    { 1, {9, taxiway_endpoints_t::START} },
+    { 2, {9, taxiway_endpoints_t::START} },
+    { 3, {9, taxiway_endpoints_t::START} },
+    { 4, {9, taxiway_endpoints_t::START} },
+    { 5, {9, taxiway_endpoints_t::START} },
+    { 6, {9, taxiway_endpoints_t::START} },
+    { 7, {9, taxiway_endpoints_t::START} },
+    { 8, {9, taxiway_endpoints_t::START} },
+    { 9, {9, taxiway_endpoints_t::START} },
+    { 10, {9, taxiway_endpoints_t::START} },
+    { 11, {9, taxiway_endpoints_t::START} },
+    { 12, {9, taxiway_endpoints_t::START} },
+    { 13, {9, taxiway_endpoints_t::START} },
+    { 14, {9, taxiway_endpoints_t::START} },
+    { 57, {9, taxiway_endpoints_t::END} },
+    { 46, {0, taxiway_endpoints_t::START} },
+    { FAKE_POINT, {0, taxiway_endpoints_t::END} },
+    { 15, {8, taxiway_endpoints_t::START} },
+    { 16, {8, taxiway_endpoints_t::START} },
+    { 17, {8, taxiway_endpoints_t::START} },
+    { 18, {8, taxiway_endpoints_t::START} },
+    { 19, {8, taxiway_endpoints_t::START} },
+    { 20, {8, taxiway_endpoints_t::START} },
+    { 65, {8, taxiway_endpoints_t::END} },
+    { 64, {1, taxiway_endpoints_t::START} },
+    { 69, {1, taxiway_endpoints_t::END} },
+    { 68, {0, taxiway_endpoints_t::START} },
+    { 21, {7, taxiway_endpoints_t::START} },
+    { 22, {7, taxiway_endpoints_t::START} },
+    { 23, {7, taxiway_endpoints_t::START} },
+    { 24, {7, taxiway_endpoints_t::START} },
+    { 25, {7, taxiway_endpoints_t::START} },
+    { 26, {7, taxiway_endpoints_t::START} },
+    { 27, {7, taxiway_endpoints_t::START} },
+    { 28, {7, taxiway_endpoints_t::START} },
+    { 81, {7, taxiway_endpoints_t::END} },
+    { 80, {10, taxiway_endpoints_t::START} },
+    { 88, {10, taxiway_endpoints_t::END} },
+    { 87, {1, taxiway_endpoints_t::START} },
+    { 29, {6, taxiway_endpoints_t::START} },
+    { 30, {6, taxiway_endpoints_t::START} },
+    { 31, {6, taxiway_endpoints_t::START} },
+    { 32, {6, taxiway_endpoints_t::START} },
+    { 33, {6, taxiway_endpoints_t::START} },
+    { 34, {6, taxiway_endpoints_t::START} },
+    { 35, {6, taxiway_endpoints_t::START} },
+    { 36, {6, taxiway_endpoints_t::START} },
+    { 37, {6, taxiway_endpoints_t::START} },
+    { 38, {6, taxiway_endpoints_t::START} },
+    { 39, {6, taxiway_endpoints_t::START} },
+    { 97, {6, taxiway_endpoints_t::END} },
+    { 96, {10, taxiway_endpoints_t::START} },
+    { 118, {4, taxiway_endpoints_t::START} },
+    { 119, {10, taxiway_endpoints_t::END} },
+    { 122, {0, taxiway_endpoints_t::START} },
+    { 123, {4, taxiway_endpoints_t::END} },
+    { 156, {2, taxiway_endpoints_t::END} },
+    { 157, {0, taxiway_endpoints_t::START} },
+    { 158, {10, taxiway_endpoints_t::END} },
+    { 159, {2, taxiway_endpoints_t::START} }
+};
+
+} // namespace
+
+reference_engine::reference_engine(unsigned seed)
+    : generator(seed),
+      taxiway_que(TAXIWAY_COUNT)
+{}
+
+
+void reference_engine::update_aerodrome() {
+
+    assert(plane_number_ <= SPAWNPOINT.size());
+    departed_flights = 0;
+
+    unordered_set<size_t> non_free_ids;
+    unordered_set<size_t> non_free_points;
+    vector<pair<size_t, size_t>> next_departures;
+    vector<pair<size_t, deque<size_t>>> next_arrivals;
+
+    auto fix_non_free = [&](size_t id, size_t step) -> void {
+        non_free_ids.insert(id);
+        non_free_points.insert(step);
+    };
+
+    auto make_step_departure = [&](size_t id, size_t step) -> void {
+        next_departures.push_back({id, step});
+        fix_non_free(id, step);
+    };
+
+    auto make_step_arrival = [&](size_t id, deque<size_t>& steps) -> void {
+        if (steps.empty()) {
+            return;
+        }
+        fix_non_free(id, steps.front());
+        next_arrivals.push_back({id, std::move(steps)});
+    };
+
+    auto in_ith_queue = [&](size_t que_id, size_t plane_id) -> bool {
+        deque<size_t> que_copy = taxiway_que[que_id];
+        while (!que_copy.empty()) {
+            if (que_copy.front() == plane_id) {
+                return true;
+            }
+            que_copy.pop_front();
+        }
+        return false;
+    };
+
+    auto compute_queues = [&](size_t id, size_t current_point, size_t step_point,
+            taxiway_endpoints_t START = taxiway_endpoints_t::START,
+            taxiway_endpoints_t END = taxiway_endpoints_t::END,
+            bool last_one = false) -> size_t {
+
+        if (TAXIWAY_ENDPOINTS.count(current_point)) {
+            size_t result = SKIP_POINT;
+            auto [way_id, point_type] = TAXIWAY_ENDPOINTS[current_point];
+
+            if (point_type == START && !in_ith_queue(way_id, id)) {
+                taxiway_que[way_id].push_back(id);
+            }
+
+            if (taxiway_que[way_id].front() == id) {
+                if (!last_one) {
+                    result = step_point;
+                }
+                if (point_type == END) {
+                    taxiway_que[way_id].pop_front();
+                }
+            } else {
+                result = current_point;
+            }
+            return result;
+        }
+        return FAIL_POINT;
+    };
+
+
+
+    helper_position += helper_position_delta;
+    if (helper_position == 0 || helper_position == HELPER_TRAJECTORY.size()) {
+        helper_position_delta = 0;
+    }
+
+    // helper starts moving with 0.04 frequency
+    if (helper_position_delta == 0 && random_below(25) == 0) {
+        helper_position_delta = (helper_position == 0 ? 1 : -1);
+    }
+
+
+    for (size_t i = 0; i != departure_aircrafts.size(); ++i) {
+        size_t id = departure_aircrafts[i].first;
+        size_t current_point = departure_aircrafts[i].second;
+
+        if (DEPARTURES_TRAJECTORY.count(current_point) || DEPARTURES_VARIADIC_TRAJECTORY.count(current_point)) {
+            size_t step_point = DEPARTURES_TRAJECTORY.count(current_point)
+                    ? DEPARTURES_TRAJECTORY[current_point]
+                    : DEPARTURES_VARIADIC_TRAJECTORY[current_point][random_below(DEPARTURES_VARIADIC_TRAJECTORY[current_point].size())];
+
+            if (non_free_points.count(step_point)) {
+                make_step_departure(id, current_point);
+            } else {
+                size_t result = compute_queues(id, current_point, step_point);
+                if (result == FAIL_POINT) {
+                    make_step_departure(id, step_point);
+                } else {
+                    if (result != SKIP_POINT) {
+                        make_step_departure(id, result);
+                    }
+                }
+            }
+        } else {
+            size_t result = compute_queues(id, current_point, current_point, taxiway_endpoints_t::START, taxiway_endpoints_t::END, true);
+            if (result != FAIL_POINT && result != SKIP_POINT) {
+                make_step_departure(id, result);
+            } else {
+                ++departed_flights;
+            }
+        }
+    }
+
+    departure_aircrafts.swap(next_departures);
+    next_departures.clear();
+
+
+    for (size_t i = 0; i != arrival_aircrafts.size(); ++i) {
+        size_t id = arrival_aircrafts[i].first;
+        deque<size_t>& all_steps = arrival_aircrafts[i].second;
+
+        if (arival_waiting_aircrafts.count(id)) {
+            next_arrivals.push_back({id, std::move(all_steps)});
+            continue;
+        }
+
+        size_t current_point = all_steps.front();
+        all_steps.pop_front();
+
+        if (!all_steps.empty()) {
+            size_t step_point = all_steps.front();
+
+            if (non_free_points.count(step_point)) {
+                all_steps.push_front(current_point);
+                make_step_arrival(id, all_steps);
+
+            } else {
+                size_t result = compute_queues(id, current_point, step_point, taxiway_endpoints_t::IGNORE, taxiway_endpoints_t::START);
+                if (result == FAIL_POINT) {
+                    make_step_arrival(id, all_steps);
+                } else {
+                    if (result != SKIP_POINT) {
+                        if (result == current_point) {
+                            all_steps.push_front(current_point);
+                        }
+                        make_step_arrival(id, all_steps);
+                    }
+                }
+            }
+        } else {
+            compute_queues(id, current_point, current_point, taxiway_endpoints_t::IGNORE, taxiway_endpoints_t::START, true);
+        }
+    }
+
+    arrival_aircrafts.swap(next_arrivals);
+    next_arrivals.clear();
+
+
+    if (arival_waiting_aircrafts.empty()) {
+        for (size_t i = departure_aircrafts.size() + arrival_aircrafts.size(); i < plane_number_; ++i) {
+            size_t id;
+            for (;;) {
+                id = random_below(SPAWNPOINT.size());
+                if (!non_free_ids.count(id)) {
+                    break;
+                }
+            }
+
+            non_free_ids.insert(id);
+            // flight is departure with 0.66 frequency
+            if (random_below(3) != 0) {
+                departure_aircrafts.push_back({id, SPAWNPOINT[id]});
+                continue;
+            }
+
+            vector<size_t> path;
+            size_t temp = SPAWNPOINT[id];
+            vector<size_t> chosen;
+            while (temp != FAKE_POINT) {
+                path.push_back(temp);
+                if (DEPARTURES_TRAJECTORY.count(temp)) {
+                    temp = DEPARTURES_TRAJECTORY[temp];
+                } else {
+                    chosen.push_back(random_below(DEPARTURES_VARIADIC_TRAJECTORY[temp].size()));
+                    temp = DEPARTURES_VARIADIC_TRAJECTORY[temp][chosen.back()];
+                }
+            }
+            path.push_back(FAKE_POINT);
+            reverse(path.begin(), path.end());
+
+            arrival_aircrafts.push_back({id, {}});
+            for (size_t iter : path) {
+                arrival_aircrafts.back().second.push_back(iter);
+            }
+
+            if (id < 15) {
+                arival_waiting_aircrafts[id] = {0, 9};
+            } else if (id < 21) {
+                arival_waiting_aircrafts[id] = {8, 1, 0};
+            } else if (id < 29) {
+                arival_waiting_aircrafts[id] = {7, 10, 1, 0};
+            } else if (id < 40) {
+                if (!chosen.empty() && chosen[0] == 0) {
+                    arival_waiting_aircrafts[id] = {6, 10, 4, 0};
+                } else {
+                    arival_waiting_aircrafts[id] = {6, 10, 1, 0};
+                }
+            }
+        }
+    }
+
+    vector<size_t> can_arrive;
+    for (auto& [id, taxiways_needed] : arival_waiting_aircrafts) {
+        bool ok = true;
+        for (size_t i : taxiways_needed) {
+            ok &= taxiway_que[i].empty();
+        }
+        if (ok) {
+            can_arrive.push_back(id);
+            for (size_t i : taxiways_needed) {
+                taxiway_que[i].push_back(id);
+            }
+            break;
+        }
+    }
+
+    for (size_t i : can_arrive) {
+        arival_waiting_aircrafts.erase(i);
+    }
+}
+
+
+void reference_engine::set_plane_number(size_t value) {
+    plane_number_ = value;
+}
+
+size_t reference_engine::plane_number() const {
+    return plane_number_;
+}
+
+
+const vector<pair<size_t, size_t>>& reference_engine::departures() const {
+    return departure_aircrafts;
+}
+
+const vector<pair<size_t, deque<size_t>>>& reference_engine::arrivals() const {
+    return arrival_aircrafts;
+}
+
+const unordered_map<size_t, vector<size_t>>& reference_engine::waiting_arrivals() const {
+    return arival_waiting_aircrafts;
+}
+
+const vector<deque<size_t>>& reference_engine::taxiway_queues() const {
+    return taxiway_que;
+}
+
+size_t reference_engine::helper_point() const {
+    if (helper_position == 0 || helper_position == HELPER_TRAJECTORY.size()) {
+        return FAKE_POINT;
+    }
+    return HELPER_TRAJECTORY[helper_position];
+}
+
+size_t reference_engine::helper_index() const {
+    return helper_position;
+}
+
+int reference_engine::helper_delta() const {
+    return helper_position_delta;
+}
+
+size_t reference_engine::inbound() const {
+    return 0;
+}
+
+size_t reference_engine::parked() const {
+    return 0;
+}
+
+size_t reference_engine::departed() const {
+    return departed_flights;
+}
+
+const std::mt19937& reference_engine::random_generator() const {
+    return generator;
+}
+
+
+size_t reference_engine::random_below(size_t bound) {
+    return generator() % bound;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "aerodrome_engine.h"
+
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::deque;
+using std::pair;
+using std::size_t;
+using std::unordered_map;
+using std::vector;
+
+
+// The schedule of the original radar_emulator_widget on plain std containers
+// and without any of the later optimizations, with its own copy of the
+// topology. Only what the comparison needs differs from the original: it draws
+// from an mt19937 in the order aerodrome_engine does instead of from rand(), so
+// both engines started from one seed make the same schedule; the taxiway
+// queues are deques so they can be walked; FAKE_POINT is a constant instead of
+// depending on the initialization order. Do not optimize or change it: it is
+// the reference aerodrome_engine is compared with in the differential mode.
+class reference_engine {
+public:
+    explicit reference_engine(unsigned seed = std::mt19937::default_seed);
+
+    void update_aerodrome();
+
+    void set_plane_number(size_t value);
+    size_t plane_number() const;
+
+    const vector<pair<size_t, size_t>>& departures() const;
+    const vector<pair<size_t, deque<size_t>>>& arrivals() const;
+    const unordered_map<size_t, vector<size_t>>& waiting_arrivals() const;
+    // used as queues, deques only to be walked by the comparison
+    const vector<deque<size_t>>& taxiway_queues() const;
+    size_t helper_point() const;
+    size_t helper_index() const;
+    int helper_delta() const;
+    // the reference is never part of a network, nothing lands or parks
+    size_t inbound() const;
+    size_t parked() const;
+    // departures which left the aerodrome during the last tick
+    size_t departed() const;
+    const std::mt19937& random_generator() const;
+
+private:
+    size_t random_below(size_t bound);
+
+private:
+    std::mt19937 generator;
+    size_t plane_number_{2};
+    size_t helper_position{0};
+    int helper_position_delta{0};
+    size_t departed_flights{0};
+    vector<pair<size_t, size_t>> departure_aircrafts;
+    vector<pair<size_t, deque<size_t>>> arrival_aircrafts;
+    unordered_map<size_t, vector<size_t>> arival_waiting_aircrafts;
+    vector<deque<size_t>> taxiway_que;
+};
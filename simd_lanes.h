@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AERODROME_SSE
+#endif
+
+
+namespace detail {
+
+// Struct-of-arrays data is padded to whole lanes, so the SSE kernels never
+// need a partial load; targets without SSE run the scalar tails only.
+inline std::size_t round_up(std::size_t value, std::size_t lane) {
+    return (value + lane - 1) / lane * lane;
+}
+
+} // namespace detail
@@ -0,0 +1,109 @@
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+spatial_grid::spatial_grid(float width, float height, float cell_size, size_t items)
+    : cell_size(cell_size),
+      columns(static_cast<size_t>(std::ceil(width / cell_size))),
+      rows(static_cast<size_t>(std::ceil(height / cell_size))),
+      cells(columns * rows),
+      item_cell(items, NO_ITEM),
+      item_offset(items, 0),
+      item_x(items, 0),
+      item_y(items, 0)
+{}
+
+
+void spatial_grid::update(size_t item, float x, float y) {
+    item_x[item] = x;
+    item_y[item] = y;
+
+    size_t cell = cell_of(x, y);
+    if (item_cell[item] == cell) {
+        return;
+    }
+    remove(item);
+
+    item_cell[item] = cell;
+    item_offset[item] = cells[cell].size();
+    cells[cell].push_back(item);
+}
+
+
+void spatial_grid::remove(size_t item) {
+    size_t cell = item_cell[item];
+    if (cell == NO_ITEM) {
+        return;
+    }
+
+    vector<size_t>& members = cells[cell];
+    size_t offset = item_offset[item];
+    members[offset] = members.back();
+    item_offset[members[offset]] = offset;
+    members.pop_back();
+    item_cell[item] = NO_ITEM;
+}
+
+
+bool spatial_grid::contains(size_t item) const {
+    return item_cell[item] != NO_ITEM;
+}
+
+
+void spatial_grid::query_rect(float left, float top, float right, float bottom, vector<size_t>& result) const {
+    size_t first_column = column_of(left);
+    size_t last_column = column_of(right);
+    size_t first_row = row_of(top);
+    size_t last_row = row_of(bottom);
+
+    for (size_t row = first_row; row <= last_row; ++row) {
+        for (size_t column = first_column; column <= last_column; ++column) {
+            for (size_t item : cells[row * columns + column]) {
+                float x = item_x[item];
+                float y = item_y[item];
+                if (left <= x && x <= right && top <= y && y <= bottom) {
+                    result.push_back(item);
+                }
+            }
+        }
+    }
+}
+
+
+size_t spatial_grid::query_nearest(float x, float y, float radius) const {
+    size_t result = NO_ITEM;
+    float best = radius * radius;
+
+    for (size_t row = row_of(y - radius); row <= row_of(y + radius); ++row) {
+        for (size_t column = column_of(x - radius); column <= column_of(x + radius); ++column) {
+            for (size_t item : cells[row * columns + column]) {
+                float dx = item_x[item] - x;
+                float dy = item_y[item] - y;
+                float distance = dx * dx + dy * dy;
+                if (distance <= best) {
+                    best = distance;
+                    result = item;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+
+size_t spatial_grid::cell_of(float x, float y) const {
+    return row_of(y) * columns + column_of(x);
+}
+
+// positions outside the plane fall into the border cells
+size_t spatial_grid::column_of(float x) const {
+    float column = std::floor(x / cell_size);
+    return static_cast<size_t>(std::clamp(column, 0.0f, static_cast<float>(columns - 1)));
+}
+
+size_t spatial_grid::row_of(float y) const {
+    float row = std::floor(y / cell_size);
+    return static_cast<size_t>(std::clamp(row, 0.0f, static_cast<float>(rows - 1)));
+}
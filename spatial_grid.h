@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Uniform grid over a width x height plane for point and region queries on
+// moving items. An item is relinked only when it crosses a cell border, and a
+// query visits just the cells it overlaps.
+class spatial_grid {
+public:
+    constexpr static size_t NO_ITEM = static_cast<size_t>(-1);
+
+    spatial_grid(float width, float height, float cell_size, size_t items);
+
+    // inserts the item or moves it to (x, y)
+    void update(size_t item, float x, float y);
+    void remove(size_t item);
+    bool contains(size_t item) const;
+
+    // appends items with left <= x <= right and top <= y <= bottom
+    void query_rect(float left, float top, float right, float bottom, vector<size_t>& result) const;
+    // the closest item not farther than radius from (x, y)
+    size_t query_nearest(float x, float y, float radius) const;
+
+private:
+    size_t cell_of(float x, float y) const;
+    size_t column_of(float x) const;
+    size_t row_of(float y) const;
+
+private:
+    float cell_size;
+    size_t columns;
+    size_t rows;
+    vector<vector<size_t>> cells;
+
+    vector<size_t> item_cell;
+    // index of the item inside its cell, for constant time unlinking
+    vector<size_t> item_offset;
+    vector<float> item_x;
+    vector<float> item_y;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+using std::size_t;
+
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// Both ends only ever write their own index, so a push and a pop never wait
+// for each other; the indices live on separate cache lines.
+template <typename T, size_t CAPACITY>
+class spsc_queue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // producer side, false when the queue is full
+    bool push(const T& value);
+
+    // consumer side, false when the queue is empty
+    bool front(T& value) const;
+    void pop();
+
+private:
+    constexpr static size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head{0};
+    alignas(CACHE_LINE) std::atomic<size_t> tail{0};
+    alignas(CACHE_LINE) std::array<T, CAPACITY> items;
+};
+
+
+template <typename T, size_t CAPACITY>
+bool spsc_queue<T, CAPACITY>::push(const T& value) {
+    size_t back = tail.load(std::memory_order_relaxed);
+    if (back - head.load(std::memory_order_acquire) == CAPACITY) {
+        return false;
+    }
+    items[back & (CAPACITY - 1)] = value;
+    tail.store(back + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t CAPACITY>
+bool spsc_queue<T, CAPACITY>::front(T& value) const {
+    size_t first = head.load(std::memory_order_relaxed);
+    if (first == tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    value = items[first & (CAPACITY - 1)];
+    return true;
+}
+
+template <typename T, size_t CAPACITY>
+void spsc_queue<T, CAPACITY>::pop() {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,42 @@
+#include "tile_cache.h"
+
+
+tile_cache::tile_cache(size_t capacity)
+    : capacity(capacity)
+{}
+
+
+const QPixmap& tile_cache::get(const tile_pyramid& pyramid, size_t level, int column, int row) {
+    key_t key = make_key(level, column, row);
+
+    auto found = index.find(key);
+    if (found != index.end()) {
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+
+    if (entries.size() == capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(key, QPixmap::fromImage(pyramid.tile(level, column, row)));
+    index[key] = entries.begin();
+    return entries.front().second;
+}
+
+
+void tile_cache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+size_t tile_cache::size() const {
+    return entries.size();
+}
+
+
+tile_cache::key_t tile_cache::make_key(size_t level, int column, int row) {
+    return (static_cast<key_t>(level) << 48)
+         | (static_cast<key_t>(static_cast<std::uint32_t>(row)) << 24)
+         | static_cast<key_t>(static_cast<std::uint32_t>(column));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <QPixmap>
+#include <unordered_map>
+#include <utility>
+
+#include "tile_pyramid.h"
+
+using std::size_t;
+
+
+// Least recently used set of tiles uploaded as QPixmap. Only tiles that are
+// actually painted end up here, so the memory held by the GUI does not depend
+// on how deep the pyramid is.
+class tile_cache {
+public:
+    explicit tile_cache(size_t capacity);
+
+    const QPixmap& get(const tile_pyramid& pyramid, size_t level, int column, int row);
+    void clear();
+    size_t size() const;
+
+private:
+    using key_t = std::uint64_t;
+    using entry_t = std::pair<key_t, QPixmap>;
+
+    static key_t make_key(size_t level, int column, int row);
+
+private:
+    size_t capacity;
+    std::list<entry_t> entries;
+    std::unordered_map<key_t, std::list<entry_t>::iterator> index;
+};
@@ -0,0 +1,98 @@
+#include "tile_pyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+tile_pyramid::~tile_pyramid() {
+    if (builder.joinable()) {
+        builder.join();
+    }
+}
+
+
+void tile_pyramid::build(const QImage& image) {
+    vector<level_t> result;
+    QImage current = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    for (;;) {
+        level_t level;
+        level.columns = (current.width() + TILE_SIZE - 1) / TILE_SIZE;
+        level.rows = (current.height() + TILE_SIZE - 1) / TILE_SIZE;
+        level.scale = static_cast<qreal>(image.width()) / current.width();
+        level.tiles.reserve(static_cast<size_t>(level.columns * level.rows));
+
+        for (int row = 0; row != level.rows; ++row) {
+            for (int column = 0; column != level.columns; ++column) {
+                level.tiles.push_back(current.copy(column * TILE_SIZE, row * TILE_SIZE,
+                        std::min(TILE_SIZE, current.width() - column * TILE_SIZE),
+                        std::min(TILE_SIZE, current.height() - row * TILE_SIZE)));
+            }
+        }
+        result.push_back(std::move(level));
+
+        if (current.width() <= TILE_SIZE && current.height() <= TILE_SIZE) {
+            break;
+        }
+        current = current.scaled(std::max(1, current.width() / 2), std::max(1, current.height() / 2),
+                Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    source = image.size();
+    levels.swap(result);
+    built.store(true, std::memory_order_release);
+}
+
+
+bool tile_pyramid::ready() const {
+    return built.load(std::memory_order_acquire);
+}
+
+size_t tile_pyramid::level_count() const {
+    return levels.size();
+}
+
+const tile_pyramid::level_t& tile_pyramid::level(size_t id) const {
+    return levels[id];
+}
+
+QSize tile_pyramid::source_size() const {
+    return source;
+}
+
+
+size_t tile_pyramid::level_for(qreal source_per_screen_pixel) const {
+    if (source_per_screen_pixel <= 1) {
+        return 0;
+    }
+    size_t result = static_cast<size_t>(std::floor(std::log2(source_per_screen_pixel)));
+    return std::min(result, levels.size() - 1);
+}
+
+
+QRect tile_pyramid::visible_tiles(size_t level_id, const QRectF& source_rect) const {
+    const level_t& current = levels[level_id];
+    qreal tile_span = TILE_SIZE * current.scale;
+
+    int first_column = std::max(0, static_cast<int>(std::floor(source_rect.left() / tile_span)));
+    int first_row = std::max(0, static_cast<int>(std::floor(source_rect.top() / tile_span)));
+    int last_column = std::min(current.columns - 1, static_cast<int>(std::floor(source_rect.right() / tile_span)));
+    int last_row = std::min(current.rows - 1, static_cast<int>(std::floor(source_rect.bottom() / tile_span)));
+
+    return QRect(QPoint(first_column, first_row), QPoint(last_column, last_row));
+}
+
+
+QRectF tile_pyramid::tile_source_rect(size_t level_id, int column, int row) const {
+    const level_t& current = levels[level_id];
+    const QImage& image = tile(level_id, column, row);
+    qreal tile_span = TILE_SIZE * current.scale;
+    return QRectF(column * tile_span, row * tile_span,
+                  image.width() * current.scale, image.height() * current.scale);
+}
+
+
+const QImage& tile_pyramid::tile(size_t level_id, int column, int row) const {
+    const level_t& current = levels[level_id];
+    return current.tiles[static_cast<size_t>(row * current.columns + column)];
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// Mip levels of a large image cut into square tiles. Level 0 is the image itself,
+// every next level halves both dimensions until the whole level fits a single tile.
+// Tiles are kept as QImage, so the pyramid may be built outside the GUI thread.
+class tile_pyramid {
+public:
+    constexpr static int TILE_SIZE = 256;
+
+    struct level_t {
+        int columns{0};
+        int rows{0};
+        // source pixels per level pixel
+        qreal scale{1};
+        vector<QImage> tiles;
+    };
+
+    tile_pyramid() = default;
+    ~tile_pyramid();
+
+    tile_pyramid(const tile_pyramid&) = delete;
+    tile_pyramid& operator=(const tile_pyramid&) = delete;
+
+    void build(const QImage& image);
+    // builds the levels in a worker thread, `done` is called from that thread
+    template <typename callback_t>
+    void build_async(const QString& path, callback_t done);
+
+    bool ready() const;
+    size_t level_count() const;
+    const level_t& level(size_t id) const;
+    QSize source_size() const;
+
+    // coarsest level that still has at least one level pixel per screen pixel
+    size_t level_for(qreal source_per_screen_pixel) const;
+    // tiles of `level_id` intersecting `source_rect`; rects are in image pixels
+    QRect visible_tiles(size_t level_id, const QRectF& source_rect) const;
+    QRectF tile_source_rect(size_t level_id, int column, int row) const;
+    const QImage& tile(size_t level_id, int column, int row) const;
+
+private:
+    std::thread builder;
+    std::atomic<bool> built{false};
+    QSize source;
+    vector<level_t> levels;
+};
+
+
+template <typename callback_t>
+void tile_pyramid::build_async(const QString& path, callback_t done) {
+    builder = std::thread([this, path, done]() {
+        build(QImage(path));
+        done();
+    });
+}